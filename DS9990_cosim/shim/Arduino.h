@@ -0,0 +1,6 @@
+#ifndef COSIM_ARDUINO_H
+#define COSIM_ARDUINO_H
+
+// included by ds9990.c, nothing of the arduino-core is used
+
+#endif
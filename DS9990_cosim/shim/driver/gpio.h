@@ -0,0 +1,20 @@
+#ifndef COSIM_DRIVER_GPIO_H
+#define COSIM_DRIVER_GPIO_H
+
+#include <stdint.h>
+
+// the strong pullup of owb.c, there is no such gpio in the co-simulation
+typedef int gpio_num_t;
+
+typedef enum
+{
+    GPIO_MODE_INPUT,
+    GPIO_MODE_OUTPUT,
+} gpio_mode_t;
+
+static inline void gpio_pad_select_gpio(gpio_num_t gpio) { (void)gpio; }
+static inline int  gpio_reset_pin(gpio_num_t gpio) { (void)gpio; return 0; }
+static inline int  gpio_set_direction(gpio_num_t gpio, gpio_mode_t mode) { (void)gpio; (void)mode; return 0; }
+static inline int  gpio_set_level(gpio_num_t gpio, uint32_t level) { (void)gpio; (void)level; return 0; }
+
+#endif
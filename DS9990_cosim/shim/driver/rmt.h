@@ -0,0 +1,6 @@
+#ifndef COSIM_DRIVER_RMT_H
+#define COSIM_DRIVER_RMT_H
+
+typedef int rmt_channel_t; // owb_rmt.h only, the rmt-driver is not part of the co-simulation
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef COSIM_ESP_LOG_H
+#define COSIM_ESP_LOG_H
+
+#include <stdio.h> // the esp-idf log header brings it, owb.c uses sprintf()
+
+// the libs log errors on every failed transaction, the co-simulation counts them itself
+#define ESP_LOGE(tag, format, ...)  ((void)(tag))
+#define ESP_LOGW(tag, format, ...)  ((void)(tag))
+#define ESP_LOGI(tag, format, ...)  ((void)(tag))
+#define ESP_LOGD(tag, format, ...)  ((void)(tag))
+#define ESP_LOGV(tag, format, ...)  ((void)(tag))
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, length, level)  ((void)(tag))
+
+#endif
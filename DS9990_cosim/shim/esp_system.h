@@ -0,0 +1,16 @@
+#ifndef COSIM_ESP_SYSTEM_H
+#define COSIM_ESP_SYSTEM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void); // us of bus-time
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
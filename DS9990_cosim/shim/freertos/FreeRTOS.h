@@ -0,0 +1,12 @@
+// esp-idf stand-in for the co-simulation: only what the esp32-owb sources use, time is the virtual bus-time
+#ifndef COSIM_FREERTOS_H
+#define COSIM_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+
+#define portTICK_PERIOD_MS  (1)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms) / portTICK_PERIOD_MS)
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef COSIM_FREERTOS_QUEUE_H
+#define COSIM_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef COSIM_FREERTOS_RINGBUF_H
+#define COSIM_FREERTOS_RINGBUF_H
+
+typedef void * RingbufHandle_t; // owb_rmt.h only, the rmt-driver is not part of the co-simulation
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef COSIM_FREERTOS_TASK_H
+#define COSIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void       vTaskDelay(TickType_t ticks); // the slaves keep running meanwhile
+TickType_t xTaskGetTickCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef COSIM_SDKCONFIG_H
+#define COSIM_SDKCONFIG_H
+
+#endif
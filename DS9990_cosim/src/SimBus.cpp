@@ -0,0 +1,242 @@
+#include "SimBus.h"
+
+SimBus *SimBus::active { nullptr };
+
+SimBus::SimBus(const uint8_t pin) : pin(pin)
+{
+    hub_count = 0;
+    for (uint8_t i = 0; i < HUB_LIMIT; ++i)
+        hub_list[i] = nullptr;
+
+    task_running    = nullptr;
+    program         = nullptr;
+    program_context = nullptr;
+    program_done    = true;
+    master_wake     = 0;
+    master_low      = false;
+
+    clearFaults();
+    clearStats();
+}
+
+bool SimBus::attach(OneWireHub &hub, const uint8_t hub_pin)
+{
+    if (hub_count >= HUB_LIMIT)
+        return false;
+
+    hostWireConnect(hub_pin, pin);
+    hub_list[hub_count] = &hub;
+    prepare(hub_task[hub_count], &SimBus::hubEntry);
+    hub_count++;
+    return true;
+}
+
+void SimBus::setFaults(const SimFaults &fault_config)
+{
+    faults       = fault_config;
+    random_state = (faults.seed != 0) ? faults.seed : 1;
+    noise_next   = 0;
+    noise_end    = 0;
+}
+
+void SimBus::clearFaults(void)
+{
+    setFaults(SimFaults { 1, 0, 0, 0, 0, 0, 0 });
+}
+
+void SimBus::run(void (* const program_fn)(void *context), void * const context)
+{
+    active          = this;
+    program         = program_fn;
+    program_context = context;
+    program_done    = false;
+    master_wake     = 0;
+    master_low      = false;
+    prepare(master_task, &SimBus::masterEntry);
+
+    hostWireAttachMaster(pin, &SimBus::level, this);
+    hostClockSetYield(&SimBus::yield);
+
+    while (!program_done)
+    {
+        hostClockAdvance(VALUE_IPL);
+        const uint64_t time_cycles = hostClockTime();
+        injectNoise(time_cycles);
+
+        if (time_cycles >= master_wake)
+            switchTo(master_task);
+
+        // every hub polls the bus once per step, a hub-coroutine only leaves at a poll
+        for (uint8_t i = 0; i < hub_count; ++i)
+            switchTo(hub_task[i]);
+    }
+
+    hostClockSetYield(nullptr);
+    hostWireAttachMaster(pin, nullptr, nullptr);
+    active = nullptr;
+}
+
+void SimBus::hubEntry(void)
+{
+    // the hub that belongs to the task was stored before the first switch
+    OneWireHub &hub = *active->hub_list[active->task_running - &active->hub_task[0]];
+    while (true)
+    {
+        boolean hasProcessed = false;
+        hub.poll(&hasProcessed);
+    }
+}
+
+void SimBus::masterEntry(void)
+{
+    SimBus &bus = *active;
+    bus.wait(TIME_SLOT_US); // the hubs start on an idle bus
+    bus.program(bus.program_context);
+    bus.master_low   = false;
+    bus.program_done = true;
+    // returning ends the coroutine, uc_link continues with the scheduler
+}
+
+void SimBus::yield(void)
+{
+    Task &task = *active->task_running;
+    swapcontext(&task.context, &active->scheduler);
+}
+
+bool SimBus::level(void * const context, const uint64_t time_cycles, const bool slave_level)
+{
+    (void)slave_level;
+    const SimBus &bus = *static_cast<SimBus *>(context);
+    return bus.master_low || (time_cycles < bus.noise_end);
+}
+
+void SimBus::prepare(Task &task, void (* const entry)(void))
+{
+    task.stack.resize(STACK_SIZE);
+    getcontext(&task.context);
+    task.context.uc_stack.ss_sp   = task.stack.data();
+    task.context.uc_stack.ss_size = task.stack.size();
+    task.context.uc_link          = &scheduler;
+    makecontext(&task.context, entry, 0);
+}
+
+void SimBus::switchTo(Task &task)
+{
+    task_running = &task;
+    swapcontext(&scheduler, &task.context);
+    task_running = nullptr;
+}
+
+void SimBus::injectNoise(const uint64_t time_cycles)
+{
+    if ((faults.noise_interval_us == 0) || (time_cycles < noise_next))
+        return;
+
+    if (noise_next != 0)
+    {
+        noise_end = time_cycles + faults.noise_us * microsecondsToClockCycles(1);
+        stats.glitches++;
+    }
+    // uniform in [0, 2 * interval], the mean is the interval
+    noise_next = time_cycles + (random() % (2 * faults.noise_interval_us + 1)) * microsecondsToClockCycles(1);
+}
+
+uint32_t SimBus::random(void)
+{
+    // xorshift32
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+bool SimBus::chance(const uint8_t percent)
+{
+    return (percent != 0) && ((random() % 100) < percent);
+}
+
+SimBus &SimBus::current(void)
+{
+    return *active;
+}
+
+void SimBus::wait(const uint32_t time_us)
+{
+    master_wake = hostClockTime() + time_us * microsecondsToClockCycles(1);
+    while (hostClockTime() < master_wake)
+        swapcontext(&master_task.context, &scheduler);
+}
+
+bool SimBus::reset(void)
+{
+    uint32_t time_low = TIME_RESET_US;
+    if (chance(faults.short_reset_percent))
+    {
+        time_low = faults.short_reset_us;
+        stats.short_resets++;
+    }
+    stats.resets++;
+
+    master_low = true;
+    wait(time_low);
+    master_low = false;
+
+    // the rmt-receiver reports a presence if there is any low state after the release
+    bool presence = false;
+    for (uint32_t time = 0; time < TIME_PRESENCE_US; ++time)
+    {
+        wait(1);
+        presence |= !hostWireLevel(pin);
+    }
+    return presence;
+}
+
+void SimBus::writeBit(const bool value)
+{
+    uint32_t time_low = value ? TIME_1_LOW_US : TIME_0_LOW_US;
+    if (chance(faults.late_slot_percent))
+    {
+        time_low += faults.late_slot_us;
+        stats.late_slots++;
+    }
+    stats.slots++;
+
+    master_low = true;
+    wait(time_low);
+    master_low = false;
+    wait((time_low < TIME_SLOT_US) ? (TIME_SLOT_US - time_low) : 1);
+}
+
+bool SimBus::readBit(void)
+{
+    uint32_t time_late = 0;
+    if (chance(faults.late_slot_percent))
+    {
+        time_late = faults.late_slot_us;
+        stats.late_slots++;
+    }
+    stats.slots++;
+
+    master_low = true;
+    wait(TIME_1_LOW_US + time_late);
+    master_low = false;
+    wait(TIME_SAMPLE_US - TIME_1_LOW_US);
+    const bool value = hostWireLevel(pin); // rising edge before the sample-time -> 1
+    wait(TIME_SLOT_US - TIME_SAMPLE_US);
+    return value;
+}
+
+uint64_t SimBus::getTime(void) const
+{
+    return hostClockTime() / microsecondsToClockCycles(1);
+}
+
+const SimStats &SimBus::getStats(void) const
+{
+    return stats;
+}
+
+void SimBus::clearStats(void)
+{
+    stats = SimStats { 0, 0, 0, 0, 0 };
+}
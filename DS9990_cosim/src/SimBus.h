@@ -0,0 +1,121 @@
+// one virtual 1-wire bus with a common timebase for the esp32-owb master and several OneWireHub instances
+// hubs and the master program run as coroutines. the scheduler advances the clock by one poll (VALUE_IPL cycles),
+// lets the master run if its next edge or sample is due and lets every hub poll once, so all of them see the
+// same bus at the same time. faults (noise, short resets, late slots) are injected on the master side.
+
+#ifndef DS9990_COSIM_SIM_BUS_H
+#define DS9990_COSIM_SIM_BUS_H
+
+#include "OneWireHub.h"
+
+#include <ucontext.h>
+#include <vector>
+
+struct SimFaults
+{
+    uint32_t seed;                // of the pseudo random faults, same seed -> same run
+    uint32_t noise_interval_us;   // mean time between glitches that pull the bus low, 0: no noise
+    uint32_t noise_us;            // length of a glitch
+    uint8_t  short_reset_percent; // resets that are shortened to short_reset_us
+    uint32_t short_reset_us;
+    uint8_t  late_slot_percent;   // slots that release the bus and sample late_slot_us later (cpu-stall of the master)
+    uint32_t late_slot_us;
+};
+
+struct SimStats
+{
+    uint32_t resets;
+    uint32_t slots;
+    uint32_t glitches;
+    uint32_t short_resets;
+    uint32_t late_slots;
+};
+
+class SimBus
+{
+private:
+
+    static constexpr uint8_t  HUB_LIMIT { 4 };
+    static constexpr uint32_t STACK_SIZE { 256 * 1024 };
+
+    // timing of the esp32 rmt-driver (owb_rmt.c)
+    static constexpr uint32_t TIME_RESET_US    { 480 };
+    static constexpr uint32_t TIME_PRESENCE_US { 480 }; // master listens for the presence after the release
+    static constexpr uint32_t TIME_SLOT_US     { 75 };
+    static constexpr uint32_t TIME_1_LOW_US    { 2 };
+    static constexpr uint32_t TIME_0_LOW_US    { 65 };
+    static constexpr uint32_t TIME_SAMPLE_US   { 13 };
+
+    struct Task
+    {
+        ucontext_t           context;
+        std::vector<uint8_t> stack;
+    };
+
+    uint8_t     pin;
+
+    OneWireHub *hub_list[HUB_LIMIT];
+    Task        hub_task[HUB_LIMIT];
+    uint8_t     hub_count;
+
+    ucontext_t  scheduler;
+    Task        master_task;
+    Task       *task_running;
+    void      (*program)(void *context);
+    void       *program_context;
+    bool        program_done;
+    uint64_t    master_wake;
+    bool        master_low;
+
+    SimFaults   faults;
+    uint32_t    random_state;
+    uint64_t    noise_next;
+    uint64_t    noise_end;
+    SimStats    stats;
+
+    static SimBus *active; // makecontext() and the yield-fn of the host backend know no context
+
+    static void hubEntry(void);
+    static void masterEntry(void);
+    static void yield(void);
+    static bool level(void *context, uint64_t time_cycles, bool slave_level);
+
+    void     prepare(Task &task, void (*entry)(void));
+    void     switchTo(Task &task);
+    void     injectNoise(uint64_t time_cycles);
+    uint32_t random(void);
+    bool     chance(uint8_t percent);
+
+public:
+
+    explicit SimBus(uint8_t pin);
+
+    ~SimBus() = default;
+
+    SimBus(const SimBus& bus) = delete;             // disallow copy constructor
+    SimBus(SimBus&& bus) = delete;                  // disallow move constructor
+    SimBus& operator=(const SimBus& bus) = delete;  // disallow copy assignment
+    SimBus& operator=(SimBus&& bus) = delete;       // disallow move assignment
+
+    // the hub has to be created with its own pin, the pin gets connected to the bus. returns false if full
+    bool attach(OneWireHub &hub, uint8_t hub_pin);
+
+    void setFaults(const SimFaults &fault_config);
+    void clearFaults(void);
+
+    // runs the master program until it returns, the hubs keep their state between runs
+    void run(void (*program_fn)(void *context), void *context);
+
+    // master side, only from within the program
+    static SimBus &current(void);
+    void     wait(uint32_t time_us);
+    bool     reset(void); // returns true if a presence was seen
+    void     writeBit(bool value);
+    bool     readBit(void);
+
+    uint64_t getTime(void) const; // us of bus-time
+    const SimStats &getStats(void) const;
+    void     clearStats(void);
+};
+
+#endif //DS9990_COSIM_SIM_BUS_H
@@ -0,0 +1,253 @@
+/*
+ *    Co-simulation of the DS9990_master (esp32-owb: owb.c, ds9990.c, ds18b20.c) against OneWireHub slaves
+ *    - two hubs share one virtual bus: DS9990 + DS18B20 and DS18B20 + DS2401
+ *    - the master uses owb_sim in place of owb_rmt, master and hubs run on one bus-time (see SimBus.h)
+ *    - scenarios: search, ds9990_write_read_memory and convert-all (convert, wait, read every DS18B20)
+ *    - per scenario: transactions, errors the master reports, silent errors (master reports ok, data is wrong),
+ *      bus-time per transaction and transactions per second of bus-time
+ *    - the same scenarios again with noise, short resets and late slots of the master
+ *
+ *    returns 1 if the run without faults has an error, so protocol changes can be checked before flashing
+ */
+
+#include "OneWireHub.h"
+#include "DS9990.h"
+#include "DS18B20.h"
+#include "DS2401.h"
+#include "SimBus.h"
+#include "owb_sim.h"
+#include "ds9990.h"
+#include "ds18b20.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+constexpr uint8_t pin_bus   { 1 };
+constexpr uint8_t pin_hub_a { 2 };
+constexpr uint8_t pin_hub_b { 3 };
+
+constexpr uint8_t sensor_count { 2 };
+constexpr uint8_t device_count { 4 };
+
+struct Result
+{
+    uint32_t transactions;
+    uint32_t errors; // the master reports an error
+    uint32_t silent; // the master reports success, but the data is wrong
+    uint64_t bus_us;
+};
+
+struct Bench
+{
+    SimBus      *sim;
+    OneWireBus  *owb;
+    DS9990      *ds9990;
+    DS18B20     *ds18b20[sensor_count];
+    OneWireBus_ROMCode rom[device_count];
+    float        temperature[sensor_count];
+
+    DS9990_Info  ds9990_info;
+    DS18B20_Info ds18b20_info[sensor_count];
+
+    uint32_t     repeat;
+    Result       result;
+};
+
+uint64_t nowNs(void)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+OneWireBus_ROMCode romOf(const OneWireItem &item)
+{
+    OneWireBus_ROMCode rom;
+    memcpy(rom.bytes, item.ID, sizeof(rom.bytes));
+    return rom;
+}
+
+void programSetup(void * const context)
+{
+    Bench &bench = *static_cast<Bench *>(context);
+    owb_use_crc(bench.owb, true);
+
+    ds9990_init(&bench.ds9990_info, bench.owb, romOf(*bench.ds9990));
+    ds9990_use_crc(&bench.ds9990_info, true);
+
+    for (uint8_t i = 0; i < sensor_count; ++i)
+    {
+        ds18b20_init(&bench.ds18b20_info[i], bench.owb, romOf(*bench.ds18b20[i]));
+        ds18b20_use_crc(&bench.ds18b20_info[i], true);
+    }
+}
+
+void programSearch(void * const context)
+{
+    Bench &bench = *static_cast<Bench *>(context);
+    for (uint32_t repeat = 0; repeat < bench.repeat; ++repeat)
+    {
+        // like the DS9990_master at startup
+        uint8_t found_mask = 0;
+        uint8_t found_unknown = 0;
+        OneWireBus_SearchState search_state;
+        memset(&search_state, 0, sizeof(search_state));
+        bool found = false;
+        const owb_status status = owb_search_first(bench.owb, &search_state, &found);
+        for (uint8_t n = 0; found && (n < 2 * device_count); ++n)
+        {
+            bool known = false;
+            for (uint8_t i = 0; i < device_count; ++i)
+            {
+                if (memcmp(search_state.rom_code.bytes, bench.rom[i].bytes, 8) == 0)
+                {
+                    found_mask |= (1 << i);
+                    known = true;
+                }
+            }
+            if (!known) found_unknown++;
+            owb_search_next(bench.owb, &search_state, &found);
+        }
+
+        bench.result.transactions++;
+        if (status != OWB_STATUS_OK)
+            bench.result.errors++;
+        else if ((found_mask != (1 << device_count) - 1) || (found_unknown != 0))
+            bench.result.silent++; // a failed search looks like the end of the list to the master
+    }
+}
+
+void programWriteRead(void * const context)
+{
+    Bench &bench = *static_cast<Bench *>(context);
+    uint8_t expected[8];
+    bench.ds9990->readMemory(expected, 8, 0);
+
+    for (uint32_t repeat = 0; repeat < bench.repeat; ++repeat)
+    {
+        // like the DS9990_master: brake-value out, 7 bytes of values in
+        uint8_t writings[1] = { static_cast<uint8_t>(repeat) };
+        uint8_t readings[7] = { 0 };
+        const DS9990_ERROR error = ds9990_write_read_memory(&bench.ds9990_info, writings, 1, readings, 7);
+
+        expected[0] = writings[0];
+        bench.result.transactions++;
+        if (error != DS9990_OK)                      bench.result.errors++;
+        else if (memcmp(readings, expected, 7) != 0) bench.result.silent++;
+    }
+}
+
+void programConvertAll(void * const context)
+{
+    Bench &bench = *static_cast<Bench *>(context);
+    for (uint32_t repeat = 0; repeat < bench.repeat; ++repeat)
+    {
+        ds18b20_convert_all(bench.owb);
+        ds18b20_wait_for_conversion(&bench.ds18b20_info[0]);
+
+        bool error = false;
+        bool wrong = false;
+        for (uint8_t i = 0; i < sensor_count; ++i)
+        {
+            float value = 0.0f;
+            error |= (ds18b20_read_temp(&bench.ds18b20_info[i], &value) != DS18B20_OK);
+            wrong |= (fabsf(value - bench.temperature[i]) > 0.0625f);
+        }
+
+        bench.result.transactions++;
+        if (error)      bench.result.errors++;
+        else if (wrong) bench.result.silent++;
+    }
+}
+
+Result runProgram(Bench &bench, void (* const program)(void *context), const char * const name, const uint32_t repeat)
+{
+    bench.repeat = repeat;
+    bench.result = Result { 0, 0, 0, 0 };
+
+    const uint64_t bus_start = bench.sim->getTime();
+    const uint64_t cpu_start = nowNs();
+    bench.sim->run(program, &bench);
+    bench.result.bus_us = bench.sim->getTime() - bus_start;
+    const uint64_t cpu_us = (nowNs() - cpu_start) / 1000;
+
+    const Result &result = bench.result;
+    const double bus_per_transaction = (result.transactions != 0) ? static_cast<double>(result.bus_us) / result.transactions : 0.0;
+    printf("  %-16s %5u x  errors %4u  silent %4u   bus %8.0f us/transaction %8.1f transactions/s   host %8llu us\n",
+           name, result.transactions, result.errors, result.silent, bus_per_transaction,
+           (bus_per_transaction > 0.0) ? 1000000.0 / bus_per_transaction : 0.0, static_cast<unsigned long long>(cpu_us));
+    return result;
+}
+
+uint32_t runScenarios(Bench &bench, const char * const name, const uint32_t repeat)
+{
+    bench.sim->clearStats();
+    printf("%s\n", name);
+
+    uint32_t failed = 0;
+    for (const Result &result : { runProgram(bench, programSearch, "search", repeat / 4 + 1),
+                                  runProgram(bench, programWriteRead, "ds9990 write+read", repeat),
+                                  runProgram(bench, programConvertAll, "convert-all", repeat / 4 + 1) })
+        failed += result.errors + result.silent;
+
+    const SimStats &stats = bench.sim->getStats();
+    printf("  %u resets, %u slots, injected: %u glitches, %u short resets, %u late slots\n\n",
+           stats.resets, stats.slots, stats.glitches, stats.short_resets, stats.late_slots);
+    return failed;
+}
+
+int main(void)
+{
+    auto hub_a   = OneWireHub(pin_hub_a);
+    auto hub_b   = OneWireHub(pin_hub_b);
+    auto ds9990  = DS9990(DS9990::family_code, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14);
+    auto ds18b20 = DS18B20(DS18B20::family_code, 0x00, 0x02, 0x0B, 0x0E, 0x0E, 0x0F);
+    auto ds18b2x = DS18B20(DS18B20::family_code, 0x00, 0x02, 0x0B, 0x0E, 0x0E, 0x10);
+    auto ds2401  = DS2401(DS2401::family_code, 0x00, 0x0D, 0x01, 0x0D, 0x01, 0x00);
+
+    hub_a.attach(ds9990);
+    hub_a.attach(ds18b20);
+    hub_b.attach(ds18b2x);
+    hub_b.attach(ds2401);
+
+    SimBus sim(pin_bus);
+    sim.attach(hub_a, pin_hub_a);
+    sim.attach(hub_b, pin_hub_b);
+
+    const uint8_t memory[8] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+    ds9990.writeMemory(memory, sizeof(memory), 0);
+    ds18b20.setTemperature(21.5f);
+    ds18b2x.setTemperature(-10.25f);
+
+    static Bench bench;
+    owb_sim_driver_info driver_info;
+    bench.sim = &sim;
+    bench.owb = owb_sim_initialize(&driver_info, sim);
+    bench.ds9990 = &ds9990;
+    bench.ds18b20[0] = &ds18b20;
+    bench.ds18b20[1] = &ds18b2x;
+    bench.rom[0] = romOf(ds9990);
+    bench.rom[1] = romOf(ds18b20);
+    bench.rom[2] = romOf(ds18b2x);
+    bench.rom[3] = romOf(ds2401);
+    bench.temperature[0] = 21.5f;
+    bench.temperature[1] = -10.25f;
+    sim.run(programSetup, &bench);
+
+    constexpr uint32_t repeat { 20 };
+    const uint32_t failed = runScenarios(bench, "no faults", repeat);
+
+    // seed, noise interval & length, short resets, late slots (all in us)
+    sim.setFaults(SimFaults { 1, 5000, 2, 0, 0, 0, 0 });
+    runScenarios(bench, "noise: 2 us glitch every 5 ms", repeat);
+
+    sim.setFaults(SimFaults { 2, 0, 0, 20, 300, 0, 0 });
+    runScenarios(bench, "short resets: 20 % with 300 us", repeat);
+
+    sim.setFaults(SimFaults { 3, 0, 0, 0, 0, 1, 30 });
+    runScenarios(bench, "late slots: 1 % released 30 us late", repeat);
+
+    sim.clearFaults();
+    printf("%s, %u errors without faults\n", (failed == 0) ? "OK" : "FAILED", failed);
+    return (failed == 0) ? 0 : 1;
+}
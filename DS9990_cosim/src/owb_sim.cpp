@@ -0,0 +1,85 @@
+#include "owb_sim.h"
+
+#define info_of_driver(owb) container_of(owb, owb_sim_driver_info, bus)
+
+static owb_status _uninitialize(const OneWireBus *bus)
+{
+    (void)bus;
+    return OWB_STATUS_OK;
+}
+
+static owb_status _reset(const OneWireBus *bus, bool *is_present)
+{
+    const bool present = info_of_driver(bus)->sim->reset();
+    if (is_present != nullptr)
+        *is_present = present;
+    return OWB_STATUS_OK;
+}
+
+static owb_status _write_bits(const OneWireBus *bus, uint8_t out, int number_of_bits_to_write)
+{
+    if (number_of_bits_to_write > 8)
+        return OWB_STATUS_TOO_MANY_BITS;
+
+    SimBus &sim = *info_of_driver(bus)->sim;
+    for (int i = 0; i < number_of_bits_to_write; ++i)
+    {
+        sim.writeBit((out & 0x01) != 0);
+        out >>= 1;
+    }
+    return OWB_STATUS_OK;
+}
+
+static owb_status _read_bits(const OneWireBus *bus, uint8_t *in, int number_of_bits_to_read)
+{
+    if (number_of_bits_to_read > 8)
+        return OWB_STATUS_TOO_MANY_BITS;
+
+    SimBus &sim = *info_of_driver(bus)->sim;
+    uint8_t read_data = 0;
+    for (int i = 0; i < number_of_bits_to_read; ++i)
+    {
+        read_data >>= 1;
+        if (sim.readBit())
+            read_data |= 0x80;
+    }
+    *in = static_cast<uint8_t>(read_data >> (8 - number_of_bits_to_read));
+    return OWB_STATUS_OK;
+}
+
+static const struct owb_driver sim_function_table =
+{
+    "owb_sim",
+    _uninitialize,
+    _reset,
+    _write_bits,
+    _read_bits
+};
+
+OneWireBus *owb_sim_initialize(owb_sim_driver_info *info, SimBus &sim)
+{
+    info->sim = &sim;
+    info->bus.timing = nullptr;
+    info->bus.use_crc = false;
+    info->bus.use_parasitic_power = false;
+    info->bus.strong_pullup_gpio = GPIO_NUM_NC;
+    info->bus.driver = &sim_function_table;
+    return &(info->bus);
+}
+
+// the esp-idf and freertos functions the esp32-owb sources use (see shim/), they run on the bus-time
+
+extern "C" void vTaskDelay(const TickType_t ticks)
+{
+    SimBus::current().wait(ticks * portTICK_PERIOD_MS * 1000);
+}
+
+extern "C" TickType_t xTaskGetTickCount(void)
+{
+    return static_cast<TickType_t>(SimBus::current().getTime() / (portTICK_PERIOD_MS * 1000));
+}
+
+extern "C" int64_t esp_timer_get_time(void)
+{
+    return static_cast<int64_t>(SimBus::current().getTime());
+}
@@ -0,0 +1,23 @@
+// owb_driver of the co-simulation, takes the place of owb_rmt.c: the slots are played on the virtual bus of a SimBus
+
+#ifndef OWB_SIM_H
+#define OWB_SIM_H
+
+#include "owb.h"
+#include "SimBus.h"
+
+struct owb_sim_driver_info
+{
+    SimBus    *sim;  ///< virtual bus, the master program has to run in SimBus::run()
+    OneWireBus bus;  ///< OneWireBus instance
+};
+
+/**
+ * @brief Initialise the simulated driver.
+ * @param[in] info Pointer to an uninitialized owb_sim_driver_info structure.
+ * @param[in] sim The virtual bus to play the slots on.
+ * @return OneWireBus *, pass this into the other OneWireBus public API functions
+ */
+OneWireBus *owb_sim_initialize(owb_sim_driver_info *info, SimBus &sim);
+
+#endif // OWB_SIM_H
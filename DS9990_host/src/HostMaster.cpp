@@ -0,0 +1,303 @@
+#include "HostMaster.h"
+#include "OneWireItem.h"
+
+namespace
+{
+    constexpr uint64_t cycles(const uint32_t time_us)
+    {
+        return static_cast<uint64_t>(time_us) * microsecondsToClockCycles(1);
+    }
+
+    // slot-number of a search pass: reset, 8 bits of the command, then 3 slots per id-bit
+    constexpr uint8_t SEARCH_SLOT_FIRST_BIT { 9 };
+    constexpr uint8_t SEARCH_SLOT_END       { SEARCH_SLOT_FIRST_BIT + (3 * 64) };
+
+    // op.value of a search: the command, this flag is added with the first pass
+    constexpr uint32_t SEARCH_STARTED { 0x100 };
+}
+
+HostMaster::HostMaster(const uint8_t pin)
+{
+    op_index = 0;
+    op_bit   = 0;
+    active   = false;
+    slot_low_end = 0;
+    slot_sample  = 0;
+    slot_end     = 0;
+    presence   = false;
+    read_value = 0;
+
+    search_last_discrepancy = 0;
+    search_last_zero   = 0;
+    search_failed      = false;
+
+    hostWireAttachMaster(pin, &HostMaster::level, this);
+}
+
+void HostMaster::reset(void)
+{
+    ops.push_back({ OpType::RESET, 0 });
+}
+
+void HostMaster::write(const uint8_t value)
+{
+    ops.push_back({ OpType::WRITE, value });
+}
+
+void HostMaster::write(const uint8_t data_array[], const uint8_t length)
+{
+    for (uint8_t i = 0; i < length; ++i)
+        write(data_array[i]);
+}
+
+void HostMaster::read(const uint8_t length)
+{
+    for (uint8_t i = 0; i < length; ++i)
+        ops.push_back({ OpType::READ, 0 });
+}
+
+void HostMaster::idle(const uint32_t time_us)
+{
+    ops.push_back({ OpType::IDLE, time_us });
+}
+
+void HostMaster::searchAll(const uint8_t command)
+{
+    ops.push_back({ OpType::SEARCH, command });
+}
+
+bool HostMaster::isDone(void) const
+{
+    return (!active) && (op_index >= ops.size());
+}
+
+bool HostMaster::getPresence(void) const
+{
+    return presence;
+}
+
+const std::vector<uint8_t> &HostMaster::getData(void) const
+{
+    return data;
+}
+
+const std::vector<uint64_t> &HostMaster::getIDs(void) const
+{
+    return ids;
+}
+
+bool HostMaster::getSearchFailed(void) const
+{
+    return search_failed;
+}
+
+void HostMaster::clear(void)
+{
+    data.clear();
+    ids.clear();
+    search_failed = false;
+}
+
+// asked by the simulated bus at every poll of the hub
+bool HostMaster::level(void * const context, const uint64_t time_cycles, const bool slave_level)
+{
+    HostMaster &master = *static_cast<HostMaster *>(context);
+
+    if (!master.active)
+    {
+        if (master.op_index >= master.ops.size())
+            return false;
+        master.playSlot(time_cycles, 0, 0, 100); // bus was idle, a polling hub sees the first falling edge
+    }
+
+    while (time_cycles >= master.slot_end)
+    {
+        if (master.slot_sample != 0)
+        {
+            master.slot_sample = 0;
+            master.sample(slave_level);
+        }
+        if (!master.startSlot(master.slot_end))
+            return false;
+    }
+
+    if ((master.slot_sample != 0) && (time_cycles >= master.slot_sample))
+    {
+        master.slot_sample = 0;
+        master.sample(slave_level);
+    }
+
+    return (time_cycles < master.slot_low_end);
+}
+
+void HostMaster::playSlot(const uint64_t time_start, const uint32_t low_us, const uint32_t sample_us, const uint32_t end_us)
+{
+    slot_low_end = time_start + cycles(low_us);
+    slot_sample  = (sample_us != 0) ? (time_start + cycles(sample_us)) : 0;
+    slot_end     = time_start + cycles(end_us);
+    active       = true;
+}
+
+bool HostMaster::startSlot(const uint64_t time_start)
+{
+    while (op_index < ops.size())
+    {
+        Op &op = ops[op_index];
+        switch (op.type)
+        {
+            case OpType::RESET:
+                if (op_bit++ == 0)
+                {
+                    playSlot(time_start, 480, 550, 960);
+                    return true;
+                }
+                break;
+
+            case OpType::WRITE:
+                if (op_bit < 8)
+                {
+                    const bool value = ((op.value >> op_bit++) & 1) != 0;
+                    playSlot(time_start, value ? 6 : 65, 0, 75);
+                    return true;
+                }
+                break;
+
+            case OpType::READ:
+                if (op_bit < 8)
+                {
+                    if (op_bit++ == 0)
+                        read_value = 0;
+                    playSlot(time_start, 6, 15, 75);
+                    return true;
+                }
+                break;
+
+            case OpType::IDLE:
+                if (op_bit++ == 0)
+                {
+                    playSlot(time_start, 0, 0, op.value);
+                    return true;
+                }
+                break;
+
+            case OpType::SEARCH:
+                if ((op_bit == 0) && ((op.value & SEARCH_STARTED) == 0))
+                {
+                    op.value |= SEARCH_STARTED; // first pass
+                    search_last_discrepancy = 0;
+                    for (uint8_t i = 0; i < 8; ++i)
+                        search_rom[i] = 0;
+                }
+
+                if (op_bit == 0)
+                {
+                    search_last_zero = 0;
+                    op_bit++;
+                    playSlot(time_start, 480, 550, 960);
+                    return true;
+                }
+                if (op_bit < SEARCH_SLOT_FIRST_BIT)
+                {
+                    if ((op_bit == 1) && !presence)
+                    {
+                        search_failed = true;
+                        break;
+                    }
+                    const bool value = ((op.value >> (op_bit++ - 1)) & 1) != 0;
+                    playSlot(time_start, value ? 6 : 65, 0, 75);
+                    return true;
+                }
+                if (op_bit < SEARCH_SLOT_END)
+                {
+                    const uint8_t slot     = static_cast<uint8_t>(op_bit++ - SEARCH_SLOT_FIRST_BIT);
+                    const uint8_t position = slot / 3;
+                    if ((slot % 3) != 2)
+                    {
+                        playSlot(time_start, 6, 15, 75); // id-bit, then its complement
+                        return true;
+                    }
+
+                    bool direction;
+                    if (search_bits[0] && search_bits[1])
+                    {
+                        search_failed = true; // nobody answered
+                        break;
+                    }
+                    else if (search_bits[0] != search_bits[1])
+                    {
+                        direction = search_bits[0];
+                    }
+                    else
+                    {
+                        if ((position + 1) < search_last_discrepancy)
+                            direction = ((search_rom[position >> 3] >> (position & 7)) & 1) != 0;
+                        else
+                            direction = ((position + 1) == search_last_discrepancy);
+                        if (!direction)
+                            search_last_zero = static_cast<uint8_t>(position + 1);
+                    }
+
+                    if (direction)
+                        search_rom[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+                    else
+                        search_rom[position >> 3] &= static_cast<uint8_t>(~(1 << (position & 7)));
+                    playSlot(time_start, direction ? 6 : 65, 0, 75);
+                    return true;
+                }
+
+                // pass is complete
+                if (OneWireItem::crc8(search_rom, 7) != search_rom[7])
+                {
+                    search_failed = true;
+                    break;
+                }
+                {
+                    uint64_t id = 0;
+                    for (uint8_t i = 8; i > 0; --i)
+                        id = (id << 8) | search_rom[i - 1];
+                    ids.push_back(id);
+                }
+                search_last_discrepancy = search_last_zero;
+                if (search_last_discrepancy != 0)
+                {
+                    op_bit = 0; // next pass
+                    continue;
+                }
+                break;
+        }
+
+        op_index++;
+        op_bit = 0;
+    }
+
+    active = false;
+    return false;
+}
+
+void HostMaster::sample(const bool slave_level)
+{
+    const Op &op = ops[op_index];
+    switch (op.type)
+    {
+        case OpType::RESET:
+            presence = !slave_level;
+            break;
+
+        case OpType::READ:
+            if (slave_level)
+                read_value |= static_cast<uint8_t>(1 << (op_bit - 1));
+            if (op_bit == 8)
+                data.push_back(read_value);
+            break;
+
+        case OpType::SEARCH:
+            if (op_bit == 1)
+                presence = !slave_level;
+            else
+                search_bits[(op_bit - SEARCH_SLOT_FIRST_BIT - 1) % 3] = slave_level;
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,78 @@
+// scripted 1-wire master for the simulated bus of the host backend (ONEWIREHUB_HOST in platform.h)
+// operations are queued first, the master plays them in virtual time while the hub polls the bus.
+// timing follows the esp32 rmt-driver of the DS9990_master: 75 us slots, 480 us reset
+
+#ifndef DS9990_HOST_MASTER_H
+#define DS9990_HOST_MASTER_H
+
+#include "OneWireHub.h"
+
+#include <vector>
+
+class HostMaster
+{
+private:
+
+    enum class OpType : uint8_t
+    {
+        RESET,
+        WRITE,
+        READ,
+        IDLE,
+        SEARCH  // search rom until the last device is found, reset and command included
+    };
+
+    struct Op
+    {
+        OpType   type;
+        uint32_t value; // byte to write, idle-time in us or command of the search
+    };
+
+    std::vector<Op> ops;
+    size_t          op_index;
+    uint8_t         op_bit;   // slot within the operation
+
+    bool     active;          // a slot is played
+    uint64_t slot_low_end;    // master releases the bus
+    uint64_t slot_sample;     // master samples the bus, 0 if not
+    uint64_t slot_end;        // next slot may start
+
+    bool     presence;
+    uint8_t  read_value;
+    std::vector<uint8_t> data;
+
+    // search rom, see maxim application note 187
+    uint8_t  search_rom[8];
+    uint8_t  search_last_discrepancy;
+    uint8_t  search_last_zero;
+    uint8_t  search_bits[2];  // id-bit and its complement of the current position
+    bool     search_failed;
+    std::vector<uint64_t> ids;
+
+    static bool level(void *context, uint64_t time_cycles, bool slave_level);
+
+    bool startSlot(uint64_t time_start); // returns false if there is nothing left to play
+    void sample(bool slave_level);
+    void playSlot(uint64_t time_start, uint32_t low_us, uint32_t sample_us, uint32_t end_us);
+
+public:
+
+    explicit HostMaster(uint8_t pin);
+
+    void reset(void);
+    void write(uint8_t value);
+    void write(const uint8_t data_array[], uint8_t length);
+    void read(uint8_t length); // bytes end up in getData()
+    void idle(uint32_t time_us);
+    void searchAll(uint8_t command = 0xF0); // SEARCH ROM, 0xEC: ALARM SEARCH
+
+    bool isDone(void) const; // everything queued is played
+
+    bool getPresence(void) const; // of the last reset
+    const std::vector<uint8_t>  &getData(void) const;
+    const std::vector<uint64_t> &getIDs(void) const; // found by searchAll(), byte 0 is the lowest
+    bool getSearchFailed(void) const;
+    void clear(void); // forget data and ids
+};
+
+#endif //DS9990_HOST_MASTER_H
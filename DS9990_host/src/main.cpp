@@ -0,0 +1,504 @@
+/*
+ *    Runs the unmodified hub and items on linux against a scripted master (see HostMaster.h)
+ *    - transactions of the DS9990_master against DS9990, DS18B20 and DS2433, checked byte by byte (search and alarm search included)
+ *    - interrupt-mode: the same transactions with the edges handled by the (emulated) pin-interrupt
+ *    - with USE_SLEEP: a hub that sleeps between the transactions (pollSleep()) has to answer every one of them
+ *    - benchmarks: attach / detach (id-tree) and a full bus search for 8 to 128 slaves, crc8 and crc16
+ *
+ *    the bus-time is virtual (see platform.h: ONEWIREHUB_HOST), the cpu-time is measured on the host.
+ *    returns 1 if a check failed
+ */
+
+#include "OneWireHub.h"
+#include "OneWireHub_crc.h"
+#include "DS9990.h"
+#include "DS18B20.h"
+#include "DS2433.h"
+#include "DS2401.h"
+#include "HostMaster.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+constexpr uint8_t pin_onewire { 1 };
+
+uint32_t failures = 0;
+
+void check(const bool condition, const char * const text)
+{
+    if (condition)
+        return;
+    printf("FAIL: %s\n", text);
+    failures++;
+}
+
+uint64_t nowNs(void)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t idOf(const OneWireItem &item)
+{
+    uint64_t id = 0;
+    for (uint8_t i = 8; i > 0; --i)
+        id = (id << 8) | item.ID[i - 1];
+    return id;
+}
+
+// lets the hub poll until the master played everything, prints bus- and cpu-time
+void serve(OneWireHub &hub, HostMaster &master, const char * const name)
+{
+    const uint64_t bus_start = hostClockTime();
+    const uint64_t cpu_start = nowNs();
+    while (!master.isDone())
+    {
+        boolean hasProcessed = false;
+        hub.poll(&hasProcessed);
+    }
+    const uint64_t bus_us = (hostClockTime() - bus_start) / microsecondsToClockCycles(1);
+    const uint64_t cpu_us = (nowNs() - cpu_start) / 1000;
+    printf("%-28s bus %8llu us   host %8llu us\n", name, static_cast<unsigned long long>(bus_us), static_cast<unsigned long long>(cpu_us));
+}
+
+void matchRom(HostMaster &master, const OneWireItem &item)
+{
+    master.reset();
+    master.write(0x55);
+    master.write(item.ID, 8);
+}
+
+void testTransactions(void)
+{
+    auto hub     = OneWireHub(pin_onewire);
+    auto master  = HostMaster(pin_onewire);
+    auto ds9990  = DS9990(DS9990::family_code, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14);
+    auto ds18b20 = DS18B20(DS18B20::family_code, 0x00, 0x02, 0x0B, 0x0E, 0x0E, 0x0F);
+    auto ds2433  = DS2433(DS2433::family_code, 0x00, 0x00, 0x33, 0x24, 0xDA, 0x00);
+
+    hub.attach(ds9990);
+    hub.attach(ds18b20);
+    hub.attach(ds2433);
+
+    // SEARCH ROM
+    master.searchAll();
+    serve(hub, master, "search 3 slaves");
+    check(!master.getSearchFailed() && (master.getIDs().size() == 3), "search finds 3 slaves");
+    for (const OneWireItem *item : { static_cast<const OneWireItem *>(&ds9990), static_cast<const OneWireItem *>(&ds18b20), static_cast<const OneWireItem *>(&ds2433) })
+    {
+        bool found = false;
+        for (const uint64_t id : master.getIDs())
+            found |= (id == idOf(*item));
+        check(found, "search finds each id");
+    }
+
+    // ALARM SEARCH: only the slaves with their alarm-flag set answer
+    master.clear();
+    ds18b20.setAlarm();
+    master.searchAll(0xEC);
+    serve(hub, master, "alarm search 1 of 3");
+#if USE_ALARM_SEARCH
+    check(!master.getSearchFailed() && (master.getIDs().size() == 1) && (master.getIDs()[0] == idOf(ds18b20)), "alarm search finds the slave with alarm");
+#else
+    check(master.getIDs().empty(), "alarm search is not answered without USE_ALARM_SEARCH");
+#endif
+    master.clear();
+    ds18b20.setAlarm(false);
+    master.searchAll(0xEC);
+    serve(hub, master, "alarm search 0 of 3");
+    check(master.getIDs().empty(), "alarm search finds nobody without alarm");
+
+    // DS9990: WRITE & READ MEMORY like ds9990_write_read_memory() of the master
+    master.clear();
+    const uint8_t brake = 0x5A;
+    matchRom(master, ds9990);
+    master.write(0xFF);
+    master.write(1);
+    master.write(brake);
+    master.write(OneWireItem::crc8(&brake, 1));
+    master.read(1); // crc as confirmation
+    master.write(7);
+    master.read(8); // memory + crc
+    serve(hub, master, "ds9990 write & read");
+    {
+        const std::vector<uint8_t> &data = master.getData();
+        uint8_t memory[7];
+        ds9990.readMemory(memory, 7, 0);
+        OneWireActivity activity;
+        check(data.size() == 9, "ds9990 answers 9 bytes");
+        check((data.size() == 9) && (data[0] == OneWireItem::crc8(&brake, 1)), "ds9990 confirms the write");
+        check((data.size() == 9) && (data[1] == brake) && (OneWireItem::crc8(&data[1], 7) == data[8]), "ds9990 sends memory with crc");
+        check(memory[0] == brake, "ds9990 memory is written");
+        check(ds9990.fetchActivity(activity) && (activity.cmd == 0xFF) && (activity.write_end == 1) && activity.read, "ds9990 marks its activity");
+    }
+
+    // DS18B20: READ SCRATCHPAD
+    master.clear();
+    ds18b20.setTemperature(static_cast<int8_t>(21));
+    matchRom(master, ds18b20);
+    master.write(0xBE);
+    master.read(9);
+    serve(hub, master, "ds18b20 read scratchpad");
+    {
+        const std::vector<uint8_t> &data = master.getData();
+        check((data.size() == 9) && (OneWireItem::crc8(data.data(), 8) == data[8]), "ds18b20 scratchpad crc");
+        check((data.size() == 9) && (static_cast<int16_t>(data[0] | (data[1] << 8)) == ds18b20.getTemperatureRaw()), "ds18b20 temperature");
+        OneWireActivity activity;
+        check(ds18b20.fetchActivity(activity) && (activity.cmd == 0xBE) && (activity.write_start == activity.write_end), "hub marks the command of ds18b20");
+    }
+#if USE_TELEMETRY
+    {
+        OneWireHubTelemetry telemetry;
+        hub.getTelemetry(telemetry);
+        const OneWireHubTelemetry::Duty &duty = telemetry.duty[1]; // ds18b20
+        check((duty.cmd[0] == 0xBE) && (duty.count[0] == 1), "telemetry counts the command of ds18b20");
+        check(telemetry.rom_cmd[static_cast<uint8_t>(RomCmd::MATCH_ROM)] == 2, "telemetry counts the match roms");
+    }
+#endif
+
+    // DS2433: READ MEMORY
+    master.clear();
+    const uint8_t text[] = "1-wire on linux";
+    ds2433.writeMemory(text, sizeof(text), 0x40);
+    matchRom(master, ds2433);
+    master.write(0xF0);
+    master.write(0x40);
+    master.write(0x00);
+    master.read(sizeof(text));
+    serve(hub, master, "ds2433 read memory");
+    {
+        const std::vector<uint8_t> &data = master.getData();
+        bool same = (data.size() == sizeof(text));
+        for (size_t i = 0; same && (i < sizeof(text)); ++i)
+            same = (data[i] == text[i]);
+        check(same, "ds2433 memory");
+    }
+}
+
+// maskInterrupts() counts nested calls, MaskScope::SLOT masks every timeslot on its own (see OneWireHubTask)
+void testMaskScope(void)
+{
+    auto hub    = OneWireHub(pin_onewire);
+    auto master = HostMaster(pin_onewire);
+    auto ds2433 = DS2433(DS2433::family_code, 0x00, 0x00, 0x33, 0x24, 0xDA, 0x00);
+
+    hub.attach(ds2433);
+
+    // like duty() around a send(): the inner pair must not unmask
+    hub.maskInterrupts();
+    hub.maskInterrupts();
+    hub.unmaskInterrupts();
+    check(hostInterruptsMasked(), "nested unmask keeps the interrupts masked");
+    hub.unmaskInterrupts();
+    check(!hostInterruptsMasked(), "outermost unmask releases the interrupts");
+
+    hub.setMaskScope(MaskScope::SLOT);
+    const uint8_t text[] = "masked per slot";
+    ds2433.writeMemory(text, sizeof(text), 0x20);
+    matchRom(master, ds2433);
+    master.write(0xF0);
+    master.write(0x20);
+    master.write(0x00);
+    master.read(sizeof(text));
+    serve(hub, master, "ds2433 read, slot masking");
+    {
+        const std::vector<uint8_t> &data = master.getData();
+        bool same = (data.size() == sizeof(text));
+        for (size_t i = 0; same && (i < sizeof(text)); ++i)
+            same = (data[i] == text[i]);
+        check(same, "slot masking serves the transaction");
+    }
+    check(!hostInterruptsMasked(), "slot masking releases the interrupts after each slot");
+
+    hub.maskInterrupts(); // does nothing with MaskScope::SLOT
+    check(!hostInterruptsMasked(), "slot masking ignores maskInterrupts()");
+    hub.unmaskInterrupts();
+}
+
+#if USE_INTERRUPT_ENGINE
+// the ISR only handles the edges, the loop serves the transactions with fetchProcessed() (see startInterruptMode())
+void testInterruptMode(void)
+{
+    auto hub     = OneWireHub(pin_onewire);
+    auto master  = HostMaster(pin_onewire);
+    auto ds9990  = DS9990(DS9990::family_code, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14);
+    auto ds18b20 = DS18B20(DS18B20::family_code, 0x00, 0x02, 0x0B, 0x0E, 0x0E, 0x0F);
+
+    hub.attach(ds9990);
+    hub.attach(ds18b20);
+    check(hub.startInterruptMode(), "interrupt-mode starts");
+
+    // the loop is busy: the ISR still shows the presence
+    master.reset();
+    master.idle(1000);
+    while (!master.isDone())
+        hostClockIdle();
+    check(master.getPresence(), "isr shows the presence while the loop is busy");
+    hub.fetchProcessed(); // the transaction is over, whatever was queued
+
+    master.searchAll();
+    ds18b20.setTemperature(static_cast<int8_t>(33));
+    matchRom(master, ds18b20);
+    master.write(0xBE);
+    master.read(9);
+    const uint8_t brake = 0xA5;
+    matchRom(master, ds9990);
+    master.write(0xFF);
+    master.write(1);
+    master.write(brake);
+    master.write(OneWireItem::crc8(&brake, 1));
+    master.read(1);
+    master.reset();
+
+    uint32_t processed = 0;
+    const uint64_t bus_start = hostClockTime();
+    while (!master.isDone())
+    {
+        if (hub.fetchProcessed()) processed++;
+        hostClockIdle();
+    }
+    hub.fetchProcessed();
+    hub.stopInterruptMode();
+    const uint64_t bus_us = (hostClockTime() - bus_start) / microsecondsToClockCycles(1);
+    printf("%-28s bus %8llu us   %u transactions\n", "interrupt-mode", static_cast<unsigned long long>(bus_us), processed);
+
+    const std::vector<uint8_t> &data = master.getData();
+    uint8_t memory[1];
+    ds9990.readMemory(memory, 1, 0);
+    check(!master.getSearchFailed() && (master.getIDs().size() == 2), "isr: search finds 2 slaves");
+    check((data.size() == 10) && (OneWireItem::crc8(data.data(), 8) == data[8]), "isr: ds18b20 scratchpad crc");
+    check((data.size() == 10) && (static_cast<int16_t>(data[0] | (data[1] << 8)) == ds18b20.getTemperatureRaw()), "isr: ds18b20 temperature");
+    check((data.size() == 10) && (data[9] == OneWireItem::crc8(&brake, 1)) && (memory[0] == brake), "isr: ds9990 write");
+    check(processed >= 3, "isr: loop serves every transaction");
+}
+#endif
+
+#if USE_SLEEP
+// the hub sleeps between the polls of the master, the reset is measured from the wake-up on (see pollSleep())
+void testSleep(void)
+{
+    auto hub     = OneWireHub(pin_onewire);
+    auto master  = HostMaster(pin_onewire);
+    auto ds18b20 = DS18B20(DS18B20::family_code, 0x00, 0x02, 0x0B, 0x0E, 0x0E, 0x0F);
+
+    hub.attach(ds18b20);
+    ds18b20.setTemperature(static_cast<int8_t>(-5));
+
+    constexpr uint8_t rounds { 4 };
+    for (uint8_t round = 0; round < rounds; ++round)
+    {
+        master.idle(20000);
+        matchRom(master, ds18b20);
+        master.write(0xBE);
+        master.read(9);
+    }
+    master.reset(); // the sleeping hub only returns on a falling edge
+
+    uint32_t slept = 0;
+    uint32_t processed = 0;
+    const uint64_t bus_start = hostClockTime();
+    while (!master.isDone())
+    {
+        boolean hasProcessed = false;
+        if (hub.pollSleep(&hasProcessed)) slept++;
+        if (hasProcessed) processed++;
+    }
+    const uint64_t bus_us = (hostClockTime() - bus_start) / microsecondsToClockCycles(1);
+    printf("%-28s bus %8llu us   %u sleeps, wake-up %u us\n", "ds18b20 with sleep", static_cast<unsigned long long>(bus_us), slept, ONEWIRE_WAKE_LATENCY_US);
+
+    const std::vector<uint8_t> &data = master.getData();
+    bool same = (data.size() == 9 * rounds);
+    for (size_t i = 0; same && (i < data.size()); ++i)
+        same = (data[i] == data[i % 9]) && ((i % 9 != 8) || (OneWireItem::crc8(&data[i - 8], 8) == data[i]));
+    // a slow wake-up only sleeps on a well predicted master, four rounds don't teach that
+    check((slept >= rounds) || (ONEWIRE_WAKE_LATENCY_US > SLEEP_EDGE_LATENCY_MAX_US), "hub sleeps between the transactions");
+    check(processed >= rounds, "sleeping hub serves every transaction");
+    check(same, "sleeping hub answers the scratchpad");
+}
+#endif
+
+void benchmarkTree(void)
+{
+    std::vector<DS2401> items; // reserved, the hub keeps pointers to them
+    items.reserve(HUB_SLAVE_LIMIT);
+    uint32_t seed = 0x1234567;
+    for (uint8_t i = 0; i < HUB_SLAVE_LIMIT; ++i)
+    {
+        uint8_t id[6];
+        for (uint8_t j = 0; j < 6; ++j)
+        {
+            seed = (seed * 1103515245) + 12345; // same ids in every run
+            id[j] = static_cast<uint8_t>(seed >> 16);
+        }
+        items.emplace_back(static_cast<uint8_t>(DS2401::family_code), id[0], id[1], id[2], id[3], id[4], id[5]);
+    }
+
+    for (const uint16_t count : { 8, 32, 64, 128 })
+    {
+        if (count > HUB_SLAVE_LIMIT)
+            break;
+
+        auto hub = OneWireHub(pin_onewire);
+        auto master = HostMaster(pin_onewire);
+
+        constexpr uint16_t rounds { 100 };
+        const uint64_t cpu_start = nowNs();
+        for (uint16_t round = 0; round < rounds; ++round)
+        {
+            for (uint16_t i = 0; i < count; ++i)
+                hub.attach(items[i]);
+            if (round == (rounds - 1))
+                break; // keep the last tree for the search
+            for (uint16_t i = 0; i < count; ++i)
+                hub.detach(items[i]);
+        }
+        const uint64_t cpu_ns = (nowNs() - cpu_start) / (static_cast<uint64_t>(rounds) * count);
+        printf("attach + detach %3u slaves   host %8llu ns per slave\n", count, static_cast<unsigned long long>(cpu_ns));
+
+        char name[32];
+        snprintf(name, sizeof(name), "search %u slaves", count);
+        master.searchAll();
+        serve(hub, master, name);
+        check(!master.getSearchFailed() && (master.getIDs().size() == count), "search finds every slave");
+    }
+}
+
+uint8_t crc8Bitwise(const uint8_t data[], const uint16_t length)
+{
+    uint8_t crc = 0;
+    for (uint16_t i = 0; i < length; ++i)
+    {
+        uint8_t value = data[i];
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            const bool mix = ((crc ^ value) & 1) != 0;
+            crc >>= 1;
+            if (mix)
+                crc ^= 0x8C;
+            value >>= 1;
+        }
+    }
+    return crc;
+}
+
+uint16_t crc16Bitwise(const uint8_t data[], const uint16_t length)
+{
+    uint16_t crc = 0;
+    for (uint16_t i = 0; i < length; ++i)
+    {
+        uint8_t value = data[i];
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            const bool mix = ((crc ^ value) & 1) != 0;
+            crc >>= 1;
+            if (mix)
+                crc ^= 0xA001;
+            value >>= 1;
+        }
+    }
+    return crc;
+}
+
+void benchmarkCRC(void)
+{
+    constexpr uint16_t length { 255 };
+    constexpr uint32_t rounds { 20000 };
+    uint8_t data[length];
+    for (uint16_t i = 0; i < length; ++i)
+        data[i] = static_cast<uint8_t>((i * 151) + 7);
+
+    volatile uint32_t sink = 0; // keeps the loops alive
+    uint64_t cpu_start = nowNs();
+    for (uint32_t round = 0; round < rounds; ++round)
+        sink += crc8Bitwise(data, length);
+    const uint64_t crc8_bitwise = nowNs() - cpu_start;
+
+    // every variant of USE_CRC8_TABLE in one run, OneWireItem::crc8() is built with one of them
+    uint8_t crc8_nibble_result = 0;
+    cpu_start = nowNs();
+    for (uint32_t round = 0; round < rounds; ++round)
+    {
+        uint8_t crc = 0;
+        for (uint16_t i = 0; i < length; ++i)
+            crc = crc8UpdateNibble(crc, data[i]);
+        crc8_nibble_result = crc;
+        sink += crc;
+    }
+    const uint64_t crc8_nibble = nowNs() - cpu_start;
+
+    uint8_t crc8_byte_result = 0;
+    cpu_start = nowNs();
+    for (uint32_t round = 0; round < rounds; ++round)
+    {
+        uint8_t crc = 0;
+        for (uint16_t i = 0; i < length; ++i)
+            crc = crc8UpdateByte(crc, data[i]);
+        crc8_byte_result = crc;
+        sink += crc;
+    }
+    const uint64_t crc8_byte = nowNs() - cpu_start;
+
+    check(crc8_nibble_result == crc8Bitwise(data, length), "crc8 nibble-table matches bitwise");
+    check(crc8_byte_result == crc8Bitwise(data, length), "crc8 byte-table matches bitwise");
+
+    cpu_start = nowNs();
+    for (uint32_t round = 0; round < rounds; ++round)
+        sink += crc16Bitwise(data, length);
+    const uint64_t crc16_bitwise = nowNs() - cpu_start;
+
+    // every variant of USE_CRC16_TABLE in one run, the hub itself is built with one of them
+    uint16_t crc16_nibble_result = 0;
+    cpu_start = nowNs();
+    for (uint32_t round = 0; round < rounds; ++round)
+    {
+        uint16_t crc = 0;
+        for (uint16_t i = 0; i < length; ++i)
+            crc = crc16UpdateNibble(crc, data[i]);
+        crc16_nibble_result = crc;
+        sink += crc;
+    }
+    const uint64_t crc16_nibble = nowNs() - cpu_start;
+
+    uint16_t crc16_byte_result = 0;
+    cpu_start = nowNs();
+    for (uint32_t round = 0; round < rounds; ++round)
+    {
+        uint16_t crc = 0;
+        for (uint16_t i = 0; i < length; ++i)
+            crc = crc16UpdateByte(crc, data[i]);
+        crc16_byte_result = crc;
+        sink += crc;
+    }
+    const uint64_t crc16_byte = nowNs() - cpu_start;
+
+    check(crc16_nibble_result == crc16Bitwise(data, length), "crc16 nibble-table matches bitwise");
+    check(crc16_byte_result == crc16Bitwise(data, length), "crc16 byte-table matches bitwise");
+
+    check(OneWireItem::crc8(data, length) == crc8Bitwise(data, length), "crc8 matches bitwise");
+    check(OneWireItem::crc16(data, length) == crc16Bitwise(data, length), "crc16 of item matches bitwise");
+
+    const double bytes = static_cast<double>(length) * rounds;
+    printf("crc8  bitwise      (table 0) host %8.2f ns per byte\n", crc8_bitwise / bytes);
+    printf("crc8  nibble-table (table 1) host %8.2f ns per byte\n", crc8_nibble / bytes);
+    printf("crc8  byte-table   (table 2) host %8.2f ns per byte   items use table %d\n", crc8_byte / bytes, USE_CRC8_TABLE);
+    printf("crc16 bitwise      (table 0) host %8.2f ns per byte\n", crc16_bitwise / bytes);
+    printf("crc16 nibble-table (table 1) host %8.2f ns per byte\n", crc16_nibble / bytes);
+    printf("crc16 byte-table   (table 2) host %8.2f ns per byte   hub uses table %d\n", crc16_byte / bytes, USE_CRC16_TABLE);
+}
+
+int main(void)
+{
+    testTransactions();
+    testMaskScope();
+#if USE_INTERRUPT_ENGINE
+    testInterruptMode();
+#endif
+#if USE_SLEEP
+    testSleep();
+#endif
+    benchmarkTree();
+    benchmarkCRC();
+
+    printf("%s, %u failed checks\n", (failures == 0) ? "OK" : "FAILED", failures);
+    return (failures == 0) ? 0 : 1;
+}
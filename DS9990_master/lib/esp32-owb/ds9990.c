@@ -346,10 +346,10 @@ DS9990_ERROR ds9990_write_read_memory(const DS9990_Info *ds9990_info, uint8_t *v
             {
                 Memory memory = {0};
 
-                if ((err = _write_memory(ds9990_info, value_w, length_w)) == DS9990_OK)
+                if (!_write_memory(ds9990_info, value_w, length_w))
                 {
                     ESP_LOGE(TAG, "ds9990_write_read_memory : write error");
-                    return err;
+                    return DS9990_ERROR_CRC;
                 }
 
                 if ((err = _read_memory(ds9990_info, &memory, length_r)) == DS9990_OK)
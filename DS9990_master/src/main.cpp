@@ -36,6 +36,7 @@
 #define MAX_DEVICES (8)
 #define SAMPLE_PERIOD (500) // milliseconds
 #define LENGHT 8
+#define SINGLE_ATTEMPT 0 // 1: count the first failed transaction as error, no retry (slaves built with USE_IRAM_HOT_PATH should not need it)
 
 void setup()
 {
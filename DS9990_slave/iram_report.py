@@ -0,0 +1,47 @@
+# post-build step: prints how much IRAM the firmware uses and which part of it belongs to the OneWireHub
+# (see USE_IRAM_HOT_PATH in lib/OWB/OneWireHub_config.h)
+import subprocess
+
+Import("env")
+
+# address-range and size of the instruction-RAM
+IRAM = {
+    "espressif8266": (0x40100000, 0x40108000),
+    "espressif32": (0x40080000, 0x400A0000),
+}
+
+HUB_SYMBOLS = ("OneWireHub", "OneWireItem", "::duty")
+
+
+def iram_report(source, target, env):
+    platform = env.subst("$PIOPLATFORM")
+    if platform not in IRAM:
+        return
+    iram_start, iram_end = IRAM[platform]
+    nm_tool = env.subst("$CC").replace("gcc", "nm")
+    elf = str(target[0])
+
+    output = subprocess.check_output([nm_tool, "-C", "-S", "--size-sort", elf]).decode()
+
+    iram_total = 0
+    hub_total = 0
+    hub_symbols = []
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) < 4:
+            continue
+        address, size = int(fields[0], 16), int(fields[1], 16)
+        if not (iram_start <= address < iram_end):
+            continue
+        iram_total += size
+        if any(key in fields[3] for key in HUB_SYMBOLS):
+            hub_total += size
+            hub_symbols.append((size, fields[3]))
+
+    print("IRAM used: %d of %d bytes (%.1f %%)" % (iram_total, iram_end - iram_start, 100.0 * iram_total / (iram_end - iram_start)))
+    print("IRAM used by hub and items: %d bytes" % hub_total)
+    for size, name in sorted(hub_symbols, reverse=True):
+        print("  %6d  %s" % (size, name))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", iram_report)
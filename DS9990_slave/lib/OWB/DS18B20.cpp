@@ -22,7 +22,7 @@ void DS18B20::updateCRC()
     scratchpad[8] = crc8(scratchpad, 8);
 }
 
-void DS18B20::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS18B20::duty(OneWireHub * const hub)
 {
     uint8_t cmd;
     if (hub->recv(&cmd,1)) return;
@@ -4,7 +4,7 @@ DS2401::DS2401(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
 {
 }
 
-void DS2401::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2401::duty(OneWireHub * const hub)
 {
     uint8_t cmd;
 
@@ -5,7 +5,7 @@ DS2408::DS2408(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     clearMemory();
 }
 
-void DS2408::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2408::duty(OneWireHub * const hub)
 {
     constexpr uint8_t DATA_xAA { 0xAA };
     uint8_t cmd, reg_TA, data; // command, targetAdress and databytes
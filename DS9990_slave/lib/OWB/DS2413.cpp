@@ -8,7 +8,7 @@ DS2413::DS2413(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     pin_latch[1] = false;
 }
 
-void DS2413::duty(OneWireHub *const hub)
+ONEWIRE_HOT void DS2413::duty(OneWireHub *const hub)
 {
     uint8_t cmd, data, datainv;
 
@@ -10,7 +10,7 @@ DS2423::DS2423(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     for (uint8_t n = 0; n < COUNTER_COUNT; ++n) setCounter(n,0);
 }
 
-void DS2423::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2423::duty(OneWireHub * const hub)
 {
     constexpr uint32_t DUMMY_32b_ZERO   { 0x00000000 }; // should be std::numeric_limits<uint32_t>::lowest()
     constexpr uint32_t DUMMY_32b_ONES   { 0xFFFFFFFF };
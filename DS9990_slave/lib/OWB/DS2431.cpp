@@ -14,7 +14,7 @@ DS2431::DS2431(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     updatePageStatus();
 }
 
-void DS2431::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2431::duty(OneWireHub * const hub)
 {
     constexpr uint8_t ALTERNATING_10 { 0xAA };
     static uint16_t   reg_TA         { 0 }; // contains TA1, TA2
@@ -99,7 +99,7 @@ void DS2431::duty(OneWireHub * const hub)
             // Write Scratchpad to memory, writing takes about 10ms
             writeMemory(scratchpad, SCRATCHPAD_SIZE, reinterpret_cast<uint8_t *>(&reg_TA)[0]); // checks if copy protected
 
-            noInterrupts();
+            hub->maskInterrupts();
 
             do
             {
@@ -110,7 +110,7 @@ void DS2431::duty(OneWireHub * const hub)
             }
             while   (hub->getError() == Error::AWAIT_TIMESLOT_TIMEOUT_HIGH); // wait for timeslots
 
-            interrupts();
+            hub->unmaskInterrupts();
 
             while (!hub->send(&ALTERNATING_10)); //  alternating 1 & 0 after copy is complete
             break;
@@ -7,7 +7,7 @@ DS2433::DS2433(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     clearScratchpad();
 }
 
-void DS2433::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2433::duty(OneWireHub * const hub)
 {
     constexpr uint8_t ALTERNATE_01 { 0b10101010 };
 
@@ -65,7 +65,7 @@ void DS2433::duty(OneWireHub * const hub)
                 writeMemory(&scratchpad[start], length, reg_TA);
             }
 
-            noInterrupts();
+            hub->maskInterrupts();
 
             do
             {
@@ -74,7 +74,7 @@ void DS2433::duty(OneWireHub * const hub)
             }
             while   (hub->getError() == Error::AWAIT_TIMESLOT_TIMEOUT_HIGH); // wait for timeslots
 
-            interrupts();
+            hub->unmaskInterrupts();
 
             while (!hub->send(&ALTERNATE_01)); // send alternating 1 & 0 after copy is complete
             break;
@@ -23,7 +23,7 @@ DS2502::DS2502(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     }
 }
 
-void DS2502::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2502::duty(OneWireHub * const hub)
 {
     uint8_t  reg_TA[2], cmd, data, crc = 0; // Target address, redirected address, command, data, crc
 
@@ -30,7 +30,7 @@ DS2506::DS2506(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     clearStatus();
 }
 
-void DS2506::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2506::duty(OneWireHub * const hub)
 {
     uint16_t reg_TA, reg_RA = 0, crc = 0; // Target address
     uint8_t  cmd, data; // redirected address, command, data, crc
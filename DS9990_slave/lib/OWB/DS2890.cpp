@@ -7,7 +7,7 @@ DS2890::DS2890(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     register_ctrl    = 0b00001100;
 }
 
-void DS2890::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2890::duty(OneWireHub * const hub)
 {
     const uint8_t poti = register_ctrl&POTI_MASK;
     uint8_t data, cmd;
@@ -48,18 +48,18 @@ void DS2890::duty(OneWireHub * const hub)
 
             if (hub->send(&register_feat))  break;
             if (hub->send(&register_ctrl))  break;
-            noInterrupts();
+            hub->maskInterrupts();
             while (!hub->sendBit(false));
-            interrupts();
+            hub->unmaskInterrupts();
             break;
 
         case 0xF0:      // READ POSITION
 
             if (hub->send(&register_ctrl))  break;
             if (hub->send(&register_poti[poti])) break;
-            noInterrupts();
+            hub->maskInterrupts();
             while (!hub->sendBit(false));
-            interrupts();
+            hub->unmaskInterrupts();
             break;
 
         case 0xC3:      // INCREMENT
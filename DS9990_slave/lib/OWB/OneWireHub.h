@@ -3,28 +3,17 @@
 
 #include "platform.h" // code for compatibility
 
-using     timeOW_t            = uint32_t;
-constexpr timeOW_t timeOW_max = 4294967295; // will arduino-gcc ever offer some stl? std::numeric_limits::max would be cleaner
-
-constexpr timeOW_t operator "" _us(const unsigned long long int time_us) // user defined literal used in config
-{
-    return timeOW_t(time_us * microsecondsToClockCycles(1) / VALUE_IPL); // note: microsecondsToClockCycles == speed in MHz....
-    // TODO: overflow detection would be nice, but literals are allowed with return-only, not solvable ATM
-}
-
-
-// same FN, but not as literal
-constexpr timeOW_t timeUsToLoops(const uint16_t time_us)
-{
-    return (time_us * microsecondsToClockCycles(1) / VALUE_IPL); // note: microsecondsToClockCycles == speed in MHz....
-}
-
 #include "OneWireHub_config.h" // outsource configfile
+#include "OneWireQueue.h"
 
 #ifndef HUB_SLAVE_LIMIT
 #error "Slavelimit not defined (why?)"
+#elif (HUB_SLAVE_LIMIT > 128)
+#error "Slavelimit is set too high (128)"
+#elif (HUB_SLAVE_LIMIT > 64)
+struct mask_t { uint32_t word[(HUB_SLAVE_LIMIT + 31) / 32]; }; // multi-word, handled by the helpers below
 #elif (HUB_SLAVE_LIMIT > 32)
-#error "Slavelimit is set too high (32)"
+using mask_t = uint64_t;
 #elif (HUB_SLAVE_LIMIT > 16)
 using mask_t = uint32_t;
 #elif (HUB_SLAVE_LIMIT > 8)
@@ -35,6 +24,65 @@ using mask_t = uint8_t;
 #error "Slavelimit is set to zero (why?)"
 #endif
 
+// index of an element in the id-tree, it holds up to (2 * HUB_SLAVE_LIMIT - 1) elements plus the marker for "no element"
+#if (HUB_SLAVE_LIMIT > 64)
+using tree_t = uint16_t;
+#else
+using tree_t = uint8_t;
+#endif
+constexpr tree_t ID_TREE_NONE { static_cast<tree_t>(~static_cast<tree_t>(0)) };
+
+// mask-helpers: one bit per slave-index, the same code works for the plain integers and the multi-word mask
+#if (HUB_SLAVE_LIMIT > 64)
+
+inline void maskClear(mask_t &mask)
+{
+    for (uint8_t i = 0; i < sizeof(mask.word) / sizeof(mask.word[0]); ++i)
+        mask.word[i] = 0;
+}
+
+inline void maskSet(mask_t &mask, const uint8_t index)
+{
+    mask.word[index >> 5] |= (static_cast<uint32_t>(1) << (index & 31));
+}
+
+inline void maskReset(mask_t &mask, const uint8_t index)
+{
+    mask.word[index >> 5] &= ~(static_cast<uint32_t>(1) << (index & 31));
+}
+
+inline bool maskTest(const mask_t &mask, const uint8_t index)
+{
+    return ((mask.word[index >> 5] >> (index & 31)) & 1) != 0;
+}
+
+inline bool maskIsEmpty(const mask_t &mask)
+{
+    for (uint8_t i = 0; i < sizeof(mask.word) / sizeof(mask.word[0]); ++i)
+        if (mask.word[i] != 0)
+            return false;
+    return true;
+}
+
+inline bool maskIsEqual(const mask_t &mask_a, const mask_t &mask_b)
+{
+    for (uint8_t i = 0; i < sizeof(mask_a.word) / sizeof(mask_a.word[0]); ++i)
+        if (mask_a.word[i] != mask_b.word[i])
+            return false;
+    return true;
+}
+
+#else
+
+inline void maskClear(mask_t &mask)                                 { mask = 0; }
+inline void maskSet(mask_t &mask, const uint8_t index)              { mask |= (static_cast<mask_t>(1) << index); }
+inline void maskReset(mask_t &mask, const uint8_t index)            { mask &= ~(static_cast<mask_t>(1) << index); }
+inline bool maskTest(const mask_t &mask, const uint8_t index)       { return ((mask >> index) & 1) != 0; }
+inline bool maskIsEmpty(const mask_t &mask)                         { return (mask == 0); }
+inline bool maskIsEqual(const mask_t &mask_a, const mask_t &mask_b) { return (mask_a == mask_b); }
+
+#endif
+
 constexpr timeOW_t VALUE1k      { 1000 }; // commonly used constant
 constexpr timeOW_t TIMEOW_MAX   { 4294967295 };   // arduino does not support std-lib...
 
@@ -57,6 +105,88 @@ enum class Error : uint8_t {
     RESET_IN_PROGRESS          = 15
 };
 
+constexpr uint8_t ERROR_COUNT { 16 };
+
+// index of the rom-command counters
+enum class RomCmd : uint8_t {
+    SEARCH_ROM                 = 0, // 0xF0
+    MATCH_ROM                  = 1, // 0x55
+    SKIP_ROM                   = 2, // 0xCC
+    RESUME                     = 3, // 0xA5
+    READ_ROM                   = 4, // 0x33 and 0x0F
+    ALARM_SEARCH               = 5, // 0xEC
+    OVERDRIVE_MATCH_ROM        = 6, // 0x69
+    OVERDRIVE_SKIP_ROM         = 7, // 0x3C
+    UNKNOWN                    = 8
+};
+
+constexpr uint8_t ROM_CMD_COUNT { 9 };
+
+// how long the hub masks the interrupts of the core while it polls the bus (see OneWireHub::setMaskScope())
+enum class MaskScope : uint8_t {
+    CALL                       = 0, // a whole send() / recv() / search and the masked parts of duty(), nested calls count
+    SLOT                       = 1  // each timeslot, reset and presence on its own, other ISRs run in between
+};
+
+enum class TraceEvent : uint8_t {
+    RESET                      = 0, // value: 1 if it was a reset, loops: remaining of RESET_MAX when the master released the bus
+    PRESENCE                   = 1, // value: 1 if the bus stayed low, loops: remaining of PRESENCE_MAX - MIN
+    SEND_BIT                   = 2, // value: the bit, loops: remaining of SLOT_MAX when the last timeslot ended
+    RECV_BIT                   = 3, // value: the bit, loops: remaining of SLOT_MAX when the last timeslot ended
+    DUTY_START                 = 4, // value: first ID-byte (family code) of the item
+    DUTY_END                   = 5  // value: error of the hub
+};
+
+struct OneWireTraceRecord
+{
+    uint32_t time;    // cpu-cycles with HUB_CYCLE_TIMING, otherwise micros()
+    timeOW_t loops;   // unit of the wait-loops (see timeOW_t)
+    uint8_t  event;   // TraceEvent
+    uint8_t  value;
+};
+
+// counters stop at 65535, read them with OneWireHub::getTelemetry()
+struct OneWireHubTelemetry
+{
+    uint16_t error[ERROR_COUNT];     // index is the Error-value, counted once when a transaction ends with it
+    uint16_t rom_cmd[ROM_CMD_COUNT]; // index is RomCmd
+
+    struct Duty {
+        uint8_t  cmd[TELEMETRY_DUTY_CMDS];   // first byte received in duty()
+        uint16_t count[TELEMETRY_DUTY_CMDS]; // 0 marks an unused slot
+        uint16_t other;                      // commands that found no free slot
+    } duty[HUB_SLAVE_LIMIT];                 // index is the slave-number of attach()
+};
+
+
+// timing of the bus, starts with the wide values of the config and is tightened to the master (USE_ADAPTIVE_TIMING)
+// unit is timeOW_t (cpu-cycles or wait-loops, see platform.h)
+struct OneWireTimingProfile
+{
+    timeOW_t slot_max[2];       // active limit: longest low state after the part of the hub, longer is a reset (index: od_mode)
+    timeOW_t msg_high_timeout;  // active limit: longest high state between two timeslots
+    timeOW_t reset_min;         // shortest / longest low state of the resets seen so far
+    timeOW_t reset_max;
+    timeOW_t slot_low_max;      // longest low state after the part of the hub (normal speed)
+    timeOW_t slot_high_max;     // longest high state between two timeslots (normal speed)
+    uint8_t  transactions;      // error-free ones since the last fallback, the profile adapts at TIMING_LEARN_TRANSACTIONS
+    bool     adapted;           // limits are tightened to the master
+};
+
+// one transaction seen by sniff(), from reset to the next reset (or idle bus)
+struct OneWireSniffRecord
+{
+    uint32_t time;                    // micros() at the end of the reset
+    uint32_t duration;                // micros() until the end of the transaction
+    uint8_t  presence;                // 1 if a slave answered the reset
+    uint8_t  rom_cmd;                 // 0 if the master sent nothing
+    uint8_t  id[8];                   // addressed (match), read or found (search) ID, zero otherwise
+    uint8_t  data_size;               // bytes after the rom-part, can exceed the stored ones (saturates at 255)
+    uint8_t  data[SNIFFER_DATA_SIZE];
+    Error    error;                   // NO_ERROR if the transaction ended with a reset or an idle bus
+};
+
+using OneWireSniffQueue = OneWireQueue<OneWireSniffRecord, SNIFFER_QUEUE_SIZE>;
 
 class OneWireItem;
 
@@ -65,7 +195,7 @@ class OneWireHub
 private:
 
     static constexpr uint8_t ONEWIRESLAVE_LIMIT                 { HUB_SLAVE_LIMIT };
-    static constexpr uint8_t ONEWIRE_TREE_SIZE                  { ( 2 * ONEWIRESLAVE_LIMIT ) - 1 };
+    static constexpr tree_t  ONEWIRE_TREE_SIZE                  { ( 2 * ONEWIRESLAVE_LIMIT ) - 1 };
 
 #if OVERDRIVE_ENABLE
     bool od_mode;
@@ -76,9 +206,20 @@ private:
     Error   _error;
     uint8_t _error_cmd;
 
+    uint8_t           pin_number;
+#if HUB_PIN_STATIC
+    static constexpr io_reg_t pin_bitMask { PIN_TO_BITMASK_STATIC(HUB_STATIC_PIN) };
+
+    static inline __attribute__((always_inline))
+    volatile io_reg_t *pinBaseReg(void) { return PIN_TO_BASEREG_STATIC(HUB_STATIC_PIN); }
+#else
     io_reg_t          pin_bitMask;
     volatile io_reg_t *pin_baseReg;
 
+    inline __attribute__((always_inline))
+    volatile io_reg_t *pinBaseReg(void) const { return pin_baseReg; }
+#endif
+
 #if true //USE_GPIO_DEBUG
     io_reg_t          debug_bitMask;
     volatile io_reg_t *debug_baseReg;
@@ -86,25 +227,157 @@ private:
 
     uint8_t      slave_count;
     OneWireItem *slave_list[ONEWIRESLAVE_LIMIT];  // private slave-list (use attach/detach)
+    mask_t       slave_mask;                      // occupied positions of slave_list
     OneWireItem *slave_selected;
+    uint8_t      slave_selected_number;           // position of slave_selected in slave_list
 
-    struct IDTree {
+#if USE_SEARCH_STREAM
+    static constexpr uint8_t SEARCH_BITS_PER_BYTE { 4 }; // (bit, complement)-pairs, lsb first
+    uint8_t search_stream[ONEWIRESLAVE_LIMIT][64 / SEARCH_BITS_PER_BYTE];
+#else
+    static constexpr uint8_t SEARCH_BITS_PER_BYTE { 8 }; // plain ID, complement is generated
+#endif
+
+    struct IDTreeElement {
         uint8_t slave_selected; // for which slave is this jump-command relevant
-        uint8_t id_position;    // where does the algorithm has to look for a junction
-        uint8_t got_zero;        // if 0 switch to which tree branch
-        uint8_t got_one;         // if 1 switch to which tree branch
-    } idTree[ONEWIRE_TREE_SIZE];
+        uint8_t id_position;    // where does the algorithm has to look for a junction, 128 for a leaf, 255 for a free element
+        tree_t  got_zero;        // if 0 switch to which tree branch (free element: next one in the free-list)
+        tree_t  got_one;         // if 1 switch to which tree branch
+    };
 
-    uint8_t buildIDTree(void);
-    uint8_t buildIDTree(uint8_t position_IDBit, mask_t slave_mask);
-    void    searchIDTree(void);
+    struct IDTree {
+        IDTreeElement element[ONEWIRE_TREE_SIZE];
+        tree_t        root;      // ID_TREE_NONE for an empty tree
+        tree_t        free;      // head of the free-list
+    };
+
+    IDTree  idTree;
+#if USE_ALARM_SEARCH
+    IDTree  idTreeAlarm;        // same as idTree, but only for the slaves with alarm-flag, used by ALARM SEARCH
+    mask_t  alarm_mask;         // slaves that are part of idTreeAlarm
+    uint8_t alarm_changes_seen; // OneWireItem::alarm_changes at the last updateAlarms()
+#endif
+
+#if OVERDRIVE_ENABLE
+    IDTree  idTreeOverdrive;      // only the slaves that support overdrive, they answer the searches in OD-Mode
+#if USE_ALARM_SEARCH
+    IDTree  idTreeOverdriveAlarm; // overdrive-slaves with alarm-flag
+#endif
+    mask_t  od_mask;              // slaves that are part of idTreeOverdrive
+#endif
+
+    // the trees are maintained incrementally, attach / detach / alarm-changes only walk one path (max 64 bit-steps)
+    void    clearIDTree(IDTree &tree);
+    void    insertIDTree(IDTree &tree, uint8_t slave_number);
+    void    removeIDTree(IDTree &tree, uint8_t slave_number);
+    void    searchIDTree(const IDTree &tree);
 
-    uint8_t getNrOfFirstBitSet(mask_t mask) const;
-    uint8_t getNrOfFirstFreeIDTreeElement(void) const;
+    void    insertIDTrees(uint8_t slave_number); // every tree the masks assign the slave to
+    void    removeIDTrees(uint8_t slave_number);
 
-    bool checkReset(void);      // returns true if error occured
+    const IDTree &getIDTree(bool alarm) const;   // depends on od_mode
+    mask_t  getSpeedMask(void) const;            // slaves that answer at the current speed
+    bool    useGpioDebug(void) const;
+
+    void    buildSearchStream(uint8_t slave_number);
+    const uint8_t *getSearchStream(uint8_t slave_number) const;
+
+#if USE_ALARM_SEARCH
+    mask_t  getAlarmMask(void) const;
+#endif
+
+    bool    getIDBit(uint8_t slave_number, uint8_t position_IDBit) const;
+    uint8_t getNrOfFirstDifferentIDBit(uint8_t slave_a, uint8_t slave_b, uint8_t position_IDBit, uint8_t position_end) const;
+
+#if USE_TELEMETRY
+    OneWireHubTelemetry  telemetry;
+#endif
+
+#if USE_TRACE
+    static_assert((TRACE_SIZE & (TRACE_SIZE - 1)) == 0, "TRACE_SIZE has to be a power of 2");
+    OneWireTraceRecord trace_buffer[TRACE_SIZE];
+    volatile uint16_t  trace_head;     // next record to write
+    volatile uint16_t  trace_tail;     // next record to read
+    uint16_t           trace_dropped;  // overwritten before they were read
+#endif
+
+    void trace(TraceEvent event, uint8_t value, timeOW_t loops);
+
+    void recordError(void);
+    void recordRomCmd(uint8_t cmd);
+    void recordDutyCmd(uint8_t cmd); // marks the function-command of the selected slave, see OneWireItem::fetchActivity()
+    void dutySelected(void);    // runs duty() of the selected slave
+
+    OneWireTimingProfile timing;
+    bool                 timing_check; // adapted profile ended a transaction by timeout, the next low state has to be a reset
+
+    void adaptTiming(void);     // called at the end of each transaction, learns or falls back
+
+    // polling period of the master, the timestamps are taken at each reset, the math waits for updatePeriod()
+    uint32_t          period_burst_start;  // micros() at the first reset of the last burst
+    volatile uint32_t period_last_reset;   // micros() at the last reset
+    volatile uint32_t period_sample;       // time between the last two bursts, waits for updatePeriod()
+    volatile bool     period_pending;
+    uint32_t          period_average;      // µs, moving average (1/8)
+    uint32_t          period_jitter;       // µs, moving average of the deviation
+    uint8_t           period_samples;      // saturates at 255
+    uint8_t           period_outliers;     // samples in a row that were far off the average
+
+    void recordReset(void);
+    void updatePeriod(void);
+
+    volatile bool activity_pending; // an item marked activity in duty(), its callback waits for the idle bus
+    bool          duty_cmd_pending; // duty() runs and hasn't received its first byte (the function-command) yet
+    timeOW_t      bus_idle;         // checkReset() saw the bus high that long, adds up over calls without a low state
+
+    MaskScope     mask_scope;
+    uint8_t       mask_depth;       // nested maskInterrupts(), only the outermost pair touches the interrupts
+
+    void maskSlot(void);            // used by the timeslots, only active with MaskScope::SLOT
+    void unmaskSlot(void);
+
+    bool checkReset(timeOW_t timeout = ONEWIRE_TIME_RESET_TIMEOUT); // returns true if error occured, timeout is the wait for a low state
+    bool checkResetLow(timeOW_t loops_passed = 0); // returns true if error occured, like checkReset() but the bus is low already
     bool showPresence(void);    // returns true if error occured
+    bool pulsePresence(void);   // returns true if the bus stayed low, doesn't touch _error (used by the ISR too)
     bool recvAndProcessCmd();   // returns true if error occured
+    bool processCmd(uint8_t cmd); // returns true if error occured
+
+    bool isrActive(void) const; // the interrupt-engine is in charge of the bus, always false without USE_INTERRUPT_ENGINE
+
+#if USE_INTERRUPT_ENGINE
+    // interrupt-engine: both edges of the bus trigger the ISR, it only takes their timestamps, turns the low states into
+    // bits or resets, shows the presence and pulls the zeros of the read-slots. the loop decodes the transactions in
+    // fetchProcessed() with sendBit() / recvBit() working on the two queues instead of the bus. the ISR doesn't decode
+    // rom-commands and has no timer for the slots, so the loop stays hard real time while a transaction lasts
+    enum class IsrState : uint8_t {
+        DISABLED                   = 0,
+        ACTIVE                     = 1
+    };
+
+    using IsrQueue = OneWireQueue<uint8_t, ISR_QUEUE_SIZE>;
+
+    volatile IsrState isr_state;
+    volatile bool     isr_running;       // inside the ISR, only the ISR may write the trace in interrupt-mode
+    volatile bool     isr_bus_low;       // the ISR saw the falling edge and waits for the rising one
+    volatile bool     isr_slot_sent;     // the current slot is a read-slot, answered from isr_tx
+    volatile uint8_t  isr_generation;    // counts the resets (7 bit), queued bits of an older transaction get dropped
+    uint32_t          isr_fall_time;     // ONEWIRE_ISR_CLOCK() at the falling edge
+    uint8_t           isr_value;         // rom-command as seen by the ISR, it has to switch to overdrive on its own
+    uint8_t           isr_bitMask;
+    uint8_t           isr_transaction;   // generation that the loop serves
+    uint8_t           isr_reset_pending; // recvBit() popped the reset of the next transaction, 0 if not
+    IsrQueue          isr_rx;            // ISR -> loop: bits written by the master, ISR_RX_RESET | generation for a reset
+    IsrQueue          isr_tx;            // loop -> ISR: bits for the read-slots of the master, bit | generation << 1
+
+    static OneWireHub *isr_hub; // attachInterrupt() takes no context -> only one hub can run in interrupt-mode
+    static void isrHandler(void);
+    void        isrEdge(void);
+    void        isrEdgeDecode(uint32_t time_now);
+    bool        isrAnswerSlot(void);     // returns true if the slot was a read-slot
+    bool        isrSendBit(bool value);  // returns true if error occured
+    bool        isrRecvBit(void);
+#endif
 
     void wait(timeOW_t loops_wait) const;
     void wait(uint16_t timeout_us) const;
@@ -130,13 +403,64 @@ public:
 
     uint8_t getIndexOfNextSensorInList(uint8_t index_start = 0) const;
 
+    void    updateAlarms(void); // rebuilds the alarm-tree if an item changed its alarm-flag (one compare otherwise), poll() does it on its own
+
     bool poll(boolean *hasProcessed);
 
+    // serves at most one transaction and waits for its reset not longer than budget_us, returns the microseconds used
+    // a transaction that started is finished (duty() included), so a long one exceeds the budget.
+    // a reset that the master started right after the transaction is picked up by the next call, if it follows soon.
+    // the callbacks run once the calls in a row saw the bus high for ONEWIRE_TIME_RESET_TIMEOUT
+    uint32_t poll(boolean *hasProcessed, uint32_t budget_us);
+
+    // for serving several buses (see OneWireHubGroup): call it right after the bus went low, handles one reset + transaction
+    // time_low_us: the bus went low that long before the call (e.g. wake-up of the mcu), it counts towards the reset
+    bool pollFallingEdge(boolean *hasProcessed, uint16_t time_low_us = 0); // returns true if the low state was a reset
+
+#if USE_SLEEP && ONEWIRE_SLEEP_SUPPORT
+    // low-power alternative to poll(): sleeps on an idle bus until the master pulls it low, then serves the transaction.
+    // a slow wake-up (ONEWIRE_WAKE_LATENCY_US > SLEEP_EDGE_LATENCY_MAX_US) would miss the reset, so the mcu only sleeps
+    // until SLEEP_GUARD_US before the predicted poll of the master. returns true if the mcu slept
+    bool pollSleep(boolean *hasProcessed);
+#endif
+
+    // listen-only alternative to poll(): the hub never drives the bus, it decodes the transactions of master and other slaves
+    // overdrive-traffic is not decoded (only its rom-command). returns true if a transaction was pushed into the queue
+    bool sniff(OneWireSniffQueue &queue);
+    bool getPinState(void) const;
+
+    // alternative to poll(): the edges of the bus are handled by a pin-interrupt, the loop is free between the
+    // transactions and serves them with fetchProcessed(). the ISR only detects edges: every bit the master reads has to be
+    // queued by the loop before its timeslot starts (e.g. the answers of a search, they depend on the bit before), so the
+    // loop stays hard real time while a transaction lasts. the ISR queues ISR_QUEUE_SIZE written bits, a blocking read of
+    // a sensor costs the current transaction (but never the presence). the presence is a busy wait inside the ISR
+#if USE_INTERRUPT_ENGINE
+    bool startInterruptMode(void); // returns false if pin has no interrupt or another hub already uses the mode
+    void stopInterruptMode(void);
+    bool fetchProcessed(void);     // serves the queued transactions, returns true if one was processed (like hasProcessed in poll()), runs the callbacks
+#endif
+
+    // critical section for the timeslots of the hub and its items, e.g. around a sendBit() of duty()
+    // masks the interrupts while the loop polls the bus (ONEWIRE_INTERRUPTS_OFF()), nested calls are counted.
+    // with MaskScope::SLOT these do nothing and every timeslot masks on its own. in interrupt-mode the ISR has to
+    // keep running (does nothing)
+    void maskInterrupts(void);
+    void unmaskInterrupts(void);
+    void setMaskScope(MaskScope scope); // only between two polls
+
+    uint8_t getPinNumber(void) const;
+
+    // runs the callbacks of items with activity (see OneWireItem::setCallback()), poll() does it on its own when the bus
+    // stayed high for ONEWIRE_TIME_RESET_TIMEOUT
+    // keep them short, the next reset of the master could be ~1 ms away
+    void runCallbacks(void);
+
     bool sendBit(bool value);                                                 // returns 1 if error occured
     bool send(uint8_t dataByte);                                              // returns 1 if error occured
     bool send(const uint8_t address[], uint8_t data_length = 1);              // returns 1 if error occured
     bool send(const uint8_t address[], uint8_t data_length, uint16_t &crc16); // returns 1 if error occured
-    // CRC takes ~7.4µs/byte (Atmega328P@16MHz) but is distributing the load between each bit-send to 0.9 µs/bit (see debug-crc-comparison.ino)
+    // CRC takes ~7.4µs/byte (Atmega328P@16MHz) bitwise, distributed between each bit-send it is 0.9 µs/bit (see debug-crc-comparison.ino)
+    // with USE_CRC16_TABLE it is a table-lookup once per byte, done while the master finishes the last timeslot
     // important: the final crc is expected to be inverted (crc=~crc) !!!
 
     bool    recvBit(void);
@@ -147,6 +471,24 @@ public:
     void     waitLoops1ms(void);
     void     waitLoopsDebug(void) const;
 
+    // snapshot of the counters, safe to call from loop() while the interrupt-engine runs. masks the interrupts for each
+    // slave on its own, so the counters of two slaves may be a transaction apart
+    void  getTelemetry(OneWireHubTelemetry &snapshot) const;
+    void  clearTelemetry(void);
+
+    // ring-buffer of the trace (USE_TRACE), oldest record first. returns false if it is empty
+    bool  fetchTrace(OneWireTraceRecord &record);
+    void  printTrace(void); // drains the buffer to Serial, one record per line
+
+    // µs until the master is expected to start its next poll, 0 if it is busy right now or due any moment
+    // confidence is 0 (nothing learned) to 255 (period without jitter), it drops with the jitter of the master
+    uint32_t timeUntilNextExpectedReset(uint8_t &confidence);
+    uint32_t getMasterPeriod(void) const; // µs, 0 if not learned yet
+
+    // the profile in use and what was measured so far, resetTimingProfile() restores the wide values and starts to learn again
+    void  getTimingProfile(OneWireTimingProfile &profile) const;
+    void  resetTimingProfile(void);
+
     // mostly for debug, partly for state-machine handling
     void  printError(void) const;
     Error getError(void) const; // returns Error
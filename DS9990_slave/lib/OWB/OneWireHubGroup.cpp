@@ -0,0 +1,101 @@
+#include "OneWireHubGroup.h"
+
+OneWireHubGroup::OneWireHubGroup(void)
+{
+    bus_count = 0;
+
+    for (uint8_t i = 0; i < BUS_LIMIT; ++i)
+    {
+        hub_list[i] = nullptr;
+        pin_state[i] = true;
+        high_since[i] = 0;
+    }
+
+    clearStats();
+}
+
+uint8_t OneWireHubGroup::attach(OneWireHub &hub)
+{
+    if (bus_count >= BUS_LIMIT)
+        return 255; // group is full
+
+#if HUB_PIN_STATIC
+    if (bus_count > 0)
+        return 255; // all hubs would share the compile-time pin
+#endif
+
+    for (uint8_t i = 0; i < bus_count; ++i)
+    {
+        if (hub_list[i] == &hub)
+            return i;
+    }
+
+    hub_list[bus_count] = &hub;
+    pin_state[bus_count] = hub.getPinState();
+    high_since[bus_count] = micros();
+    return bus_count++;
+}
+
+ONEWIRE_HOT bool OneWireHubGroup::poll(void)
+{
+    bool processed = false;
+
+    for (uint8_t i = 0; i < bus_count; ++i)
+    {
+        OneWireHub * const hub = hub_list[i];
+        const bool state = hub->getPinState();
+
+        if (pin_state[i] && !state)
+        {
+            // the master of this bus pulled low, the hub measures the rest of the low state
+            boolean hasProcessed = false;
+            if (hub->pollFallingEdge(&hasProcessed))
+                bus_stats[i].resets++;
+
+            if (hasProcessed)
+            {
+                bus_stats[i].transactions++;
+                processed = true;
+            }
+
+            const Error error = hub->getError();
+            if ((error != Error::NO_ERROR) && (error != Error::RESET_IN_PROGRESS))
+                bus_stats[i].errors++;
+
+            pin_state[i] = hub->getPinState(); // the bus may still be low, the next edge has to be a new one
+            high_since[i] = micros();
+        }
+        else
+        {
+            pin_state[i] = state;
+            if (!state)
+                high_since[i] = micros();
+            else if ((micros() - high_since[i]) >= GROUP_IDLE_US)
+                hub->runCallbacks(); // bus is idle, not just between two timeslots
+        }
+    }
+
+    return processed;
+}
+
+uint8_t OneWireHubGroup::getBusCount(void) const
+{
+    return bus_count;
+}
+
+const OneWireBusStats *OneWireHubGroup::getStats(const uint8_t bus_number) const
+{
+    if (bus_number >= bus_count)
+        return nullptr;
+    return &bus_stats[bus_number];
+}
+
+void OneWireHubGroup::clearStats(void)
+{
+    for (uint8_t i = 0; i < BUS_LIMIT; ++i)
+    {
+        bus_stats[i].resets = 0;
+        bus_stats[i].transactions = 0;
+        bus_stats[i].errors = 0;
+    }
+}
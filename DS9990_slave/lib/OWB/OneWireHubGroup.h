@@ -0,0 +1,54 @@
+// serves several independent buses from one uC, each bus gets its own hub (pin, items, id-tree)
+// the group watches the pins of all hubs and hands a falling edge to the hub of that bus,
+// the hub serves the reset and the following transaction, meanwhile the other buses are not watched.
+// IMPORTANT: the masters of the buses must not be active at the same time. a reset that starts on another bus while
+// one is served is seen late or not at all (no presence, the master retries), its transaction is lost
+
+#ifndef ONEWIREHUB_GROUP_H
+#define ONEWIREHUB_GROUP_H
+
+#include "OneWireHub.h"
+
+struct OneWireBusStats
+{
+    uint32_t resets;       // low states that were detected as reset, presence was shown
+    uint32_t transactions; // rom-command (and item duty) processed without error
+    uint32_t errors;       // transactions that ended with an error of the hub
+};
+
+class OneWireHubGroup
+{
+private:
+
+    static constexpr uint8_t BUS_LIMIT { HUB_BUS_LIMIT };
+
+    uint8_t          bus_count;
+    OneWireHub      *hub_list[BUS_LIMIT];
+    bool             pin_state[BUS_LIMIT]; // last level, a falling edge is a change from high to low
+    uint32_t         high_since[BUS_LIMIT]; // micros() when the bus was last seen low, the callbacks wait for GROUP_IDLE_US
+    OneWireBusStats  bus_stats[BUS_LIMIT];
+
+public:
+
+    OneWireHubGroup(void);
+
+    ~OneWireHubGroup() = default;
+
+    OneWireHubGroup(const OneWireHubGroup& group) = delete;             // disallow copy constructor
+    OneWireHubGroup(OneWireHubGroup&& group) = default;               // default move constructor
+    OneWireHubGroup& operator=(OneWireHubGroup& group) = delete;        // disallow copy assignment
+    OneWireHubGroup& operator=(const OneWireHubGroup& group) = delete;  // disallow copy assignment
+    OneWireHubGroup& operator=(OneWireHubGroup&& group) = delete;       // disallow move assignment
+
+    uint8_t attach(OneWireHub &hub); // returns the bus-number, 255 if the group is full (or HUB_STATIC_PIN is used by a second hub)
+
+    // looks once at every bus, should be called as often as possible. returns true if a transaction was processed
+    // the callbacks of the items run once their bus stayed high for GROUP_IDLE_US, not in the gaps between timeslots
+    bool    poll(void);
+
+    uint8_t getBusCount(void) const;
+    const OneWireBusStats *getStats(uint8_t bus_number) const; // nullptr for an unknown bus
+    void    clearStats(void);
+};
+
+#endif //ONEWIREHUB_GROUP_H
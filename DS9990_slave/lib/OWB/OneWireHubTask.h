@@ -0,0 +1,101 @@
+// runs one hub on its own core of a dual-core esp32 (ONEWIRE_TASK_SUPPORT), the application keeps the other core
+// EXPERIMENTAL: only built with USE_HUB_TASK, it has not been run on hardware yet
+// the hub-task masks the interrupts of its core for each timeslot (MaskScope::SLOT), so rtos-ticks and other isrs of
+// the core can't stretch a slot but still run in between. the task blocks until the falling edge of the next reset
+// wakes it up, between two transactions it works off the mails of the application.
+// the memory of the items is only touched on the hub-core: the application posts writes into a mailbox, the hub-task
+// sends the activity of watched items (and a copy of their memory) back. both mailboxes are lock-free (see OneWireQueue.h)
+// with one producer and one consumer, so only one application task may post and one may fetch
+
+#ifndef ONEWIREHUB_TASK_H
+#define ONEWIREHUB_TASK_H
+
+#include "OneWireHub.h"
+#include "OneWireItem.h"
+
+#if USE_HUB_TASK && ONEWIRE_TASK_SUPPORT
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <driver/gpio.h>
+
+struct OneWireMail;
+
+// access to the memory of an item, runs on the hub-core while the bus is idle. keep it short, the master may come back
+// application -> hub: write mail.length bytes of mail.data to mail.address, hub -> application: fill mail.data the same way
+using OneWireMemoryFn = void (*)(OneWireItem &item, OneWireMail &mail);
+
+struct OneWireMail
+{
+    OneWireItem     *item;
+    OneWireMemoryFn  function;
+    OneWireActivity  activity; // hub -> application: what the master did, unused in the other direction
+    uint8_t          address;  // of the memory-part in data
+    uint8_t          length;
+    uint8_t          data[HUB_TASK_MAIL_SIZE];
+};
+
+using OneWireMailQueue = OneWireQueue<OneWireMail, HUB_TASK_QUEUE_SIZE>;
+
+class OneWireHubTask
+{
+private:
+
+    struct Watch
+    {
+        OneWireItem     *item;
+        OneWireMemoryFn  reader;
+        uint8_t          address;
+        uint8_t          length;
+    };
+
+    OneWireHub       &hub;
+    TaskHandle_t      handle;
+    volatile bool     running;   // cleared by stop(), the task ends after its current poll
+    volatile uint32_t processed; // transactions, only written by the hub-task
+    volatile uint32_t edge_time; // micros() of the falling edge that woke the hub-task
+
+    Watch             watch_list[HUB_TASK_WATCH_LIMIT];
+    uint8_t           watch_count;
+
+    OneWireMailQueue  mail_in;   // application -> hub
+    OneWireMailQueue  mail_out;  // hub -> application
+
+    static OneWireHubTask *active; // the item-callback takes no context -> only one hub-task can run
+
+    static void taskEntry(void *context);
+    static void onActivity(OneWireItem &item, const OneWireActivity &activity);
+    static void onEdge(void *context);
+
+    void run(void);
+
+public:
+
+    explicit OneWireHubTask(OneWireHub &hub);
+
+    ~OneWireHubTask() = default;
+
+    OneWireHubTask(const OneWireHubTask& task) = delete;             // disallow copy constructor
+    OneWireHubTask(OneWireHubTask&& task) = default;                 // default move constructor
+    OneWireHubTask& operator=(const OneWireHubTask& task) = delete;  // disallow copy assignment
+    OneWireHubTask& operator=(OneWireHubTask&& task) = delete;       // disallow move assignment
+
+    // before start(): the activity of the item is mailed to the application, reader copies length bytes from address
+    // into the mail (nullptr: activity only). replaces the callback of the item. returns false if the list is full
+    bool watch(OneWireItem &item, OneWireMemoryFn reader, uint8_t address = 0, uint8_t length = 0);
+
+    // creates the hub-task pinned to core, returns false if a hub-task runs already or the task could not be created
+    bool start(uint8_t core = HUB_TASK_CORE, uint8_t priority = HUB_TASK_PRIORITY);
+    void stop(void); // returns once the task ended
+
+    // application: writer gets called on the hub-core with a copy of data. returns false if the mailbox is full
+    bool post(OneWireItem &item, OneWireMemoryFn writer, uint8_t address, const uint8_t data[], uint8_t length);
+    bool fetch(OneWireMail &mail); // returns false if no activity is waiting
+    uint8_t fetchDropped(void);    // activity lost since the last call, the application fetched too slowly
+
+    uint32_t getProcessed(void) const; // transactions since start()
+};
+
+#endif
+
+#endif //ONEWIREHUB_TASK_H
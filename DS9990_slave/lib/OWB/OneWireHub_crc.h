@@ -0,0 +1,129 @@
+#ifndef ONEWIREHUB_CRC_H
+#define ONEWIREHUB_CRC_H
+
+#include "platform.h"
+#include "OneWireHub_config.h"
+
+// CRC16 of type 0xA001 (little endian) for the send() / recv() with crc of the hub,
+// CRC8 (dallas / maxim, 0x8C reflected) for OneWireItem::crc8() on non-avr (avr has its own asm-version)
+// the tables are generated by the compiler, the arduino-gcc is limited to c++11 so it gets its own index-pack
+// avr: constexpr-tables are copied into the sram (no PROGMEM), so the config leaves them off there by default
+
+#if defined(__AVR__) && (USE_CRC16_TABLE != 0)
+#warning "USE_CRC16_TABLE: the table of the crc16 takes sram on avr"
+#endif
+
+template<uint16_t... index>
+struct crcIndexList { };
+
+template<uint16_t count, uint16_t... index>
+struct crcIndexBuild : crcIndexBuild<count - 1, count - 1, index...> { };
+
+template<uint16_t... index>
+struct crcIndexBuild<0, index...>
+{
+    using type = crcIndexList<index...>;
+};
+
+// feed "bits" zero-bits into the crc, the start value is the table-index
+constexpr uint16_t crc16Entry(const uint16_t crc, const uint8_t bits)
+{
+    return (bits == 0) ? crc : crc16Entry(((crc & 1) != 0) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1), static_cast<uint8_t>(bits - 1));
+}
+
+template<uint8_t bits, typename list>
+struct crc16Table;
+
+template<uint8_t bits, uint16_t... index>
+struct crc16Table<bits, crcIndexList<index...>>
+{
+    static constexpr uint16_t value[sizeof...(index)] = { crc16Entry(index, bits)... };
+};
+
+template<uint8_t bits, uint16_t... index>
+constexpr uint16_t crc16Table<bits, crcIndexList<index...>>::value[sizeof...(index)];
+
+// both variants are always there (e.g. for benchmarks), a table only ends up in the binary if its update is used
+using crc16Byte   = crc16Table<8, crcIndexBuild<256>::type>; // 512 byte
+using crc16Nibble = crc16Table<4, crcIndexBuild<16>::type>;  // 32 byte
+
+inline __attribute__((always_inline)) uint16_t crc16UpdateByte(const uint16_t crc, const uint8_t value)
+{
+    return static_cast<uint16_t>((crc >> 8) ^ crc16Byte::value[static_cast<uint8_t>(crc ^ value)]);
+}
+
+inline __attribute__((always_inline)) uint16_t crc16UpdateNibble(uint16_t crc, const uint8_t value)
+{
+    crc = static_cast<uint16_t>((crc >> 4) ^ crc16Nibble::value[(crc ^ value) & 0x0F]);
+    return static_cast<uint16_t>((crc >> 4) ^ crc16Nibble::value[(crc ^ (value >> 4)) & 0x0F]);
+}
+
+#if (USE_CRC16_TABLE == 2)
+
+inline __attribute__((always_inline)) uint16_t crc16Update(const uint16_t crc, const uint8_t value)
+{
+    return crc16UpdateByte(crc, value);
+}
+
+#elif (USE_CRC16_TABLE == 1)
+
+inline __attribute__((always_inline)) uint16_t crc16Update(const uint16_t crc, const uint8_t value)
+{
+    return crc16UpdateNibble(crc, value);
+}
+
+#endif
+
+
+// feed "bits" zero-bits into the crc, the start value is the table-index
+constexpr uint8_t crc8Entry(const uint8_t crc, const uint8_t bits)
+{
+    return (bits == 0) ? crc : crc8Entry(((crc & 1) != 0) ? static_cast<uint8_t>((crc >> 1) ^ 0x8C) : static_cast<uint8_t>(crc >> 1), static_cast<uint8_t>(bits - 1));
+}
+
+template<uint8_t shift, typename list>
+struct crc8Table;
+
+template<uint8_t shift, uint16_t... index>
+struct crc8Table<shift, crcIndexList<index...>>
+{
+    static constexpr uint8_t value[sizeof...(index)] = { crc8Entry(static_cast<uint8_t>(index << shift), 8)... };
+};
+
+template<uint8_t shift, uint16_t... index>
+constexpr uint8_t crc8Table<shift, crcIndexList<index...>>::value[sizeof...(index)];
+
+// both variants are always there (e.g. for benchmarks), a table only ends up in the binary if its update is used
+using crc8Byte       = crc8Table<0, crcIndexBuild<256>::type>; // 256 byte
+using crc8NibbleLow  = crc8Table<0, crcIndexBuild<16>::type>;  // 16 byte
+using crc8NibbleHigh = crc8Table<4, crcIndexBuild<16>::type>;  // 16 byte
+
+inline __attribute__((always_inline)) uint8_t crc8UpdateByte(const uint8_t crc, const uint8_t value)
+{
+    return crc8Byte::value[crc ^ value];
+}
+
+// the crc is linear, so the contributions of both nibbles can be combined
+inline __attribute__((always_inline)) uint8_t crc8UpdateNibble(uint8_t crc, const uint8_t value)
+{
+    crc ^= value;
+    return static_cast<uint8_t>(crc8NibbleLow::value[crc & 0x0F] ^ crc8NibbleHigh::value[crc >> 4]);
+}
+
+#if (USE_CRC8_TABLE == 2)
+
+inline __attribute__((always_inline)) uint8_t crc8Update(const uint8_t crc, const uint8_t value)
+{
+    return crc8UpdateByte(crc, value);
+}
+
+#elif (USE_CRC8_TABLE == 1)
+
+inline __attribute__((always_inline)) uint8_t crc8Update(const uint8_t crc, const uint8_t value)
+{
+    return crc8UpdateNibble(crc, value);
+}
+
+#endif
+
+#endif //ONEWIREHUB_CRC_H
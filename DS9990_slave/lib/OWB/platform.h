@@ -26,6 +26,25 @@
 #define DIRECT_WRITE_HIGH(base, mask)   ((*((base)+2)) |= (mask))
 using io_reg_t = uint8_t; // define special datatype for register-access
 constexpr uint8_t VALUE_IPL {13}; // instructions per loop, compare 0 takes 11, compare 1 takes 13 cycles
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__) /* arduino-pin n is PBn */
+#define ONEWIRE_STATIC_PIN_SUPPORT      1
+#define PIN_TO_BASEREG_STATIC(pin)      (&PINB)
+#define PIN_TO_BITMASK_STATIC(pin)      (static_cast<io_reg_t>(1 << (pin)))
+#define ONEWIRE_SLEEP_SUPPORT           1 // power-down, pin-change wake-up
+constexpr uint32_t ONEWIRE_WAKE_LATENCY_US {30000000UL / F_CPU + 1}; // datasheet: 6 CK start-up, 8 CK interrupt, ~16 CK isr -> 5 us @ 8 MHz, not measured
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__) /* uno, nano, pro mini: 0-7 PORTD, 8-13 PORTB, 14-19 PORTC */
+#define ONEWIRE_STATIC_PIN_SUPPORT      1
+#define PIN_TO_BASEREG_STATIC(pin)      (((pin) < 8) ? &PIND : (((pin) < 14) ? &PINB : &PINC))
+#define PIN_TO_BITMASK_STATIC(pin)      (static_cast<io_reg_t>(1 << (((pin) < 8) ? (pin) : (((pin) < 14) ? ((pin) - 8) : ((pin) - 14)))))
+#endif
+// the static-pin loop (sbic + 32bit-decrement) counts to ~10 cycles, but that is not measured on the bus yet. until then
+// it uses the measured VALUE_IPL, so the waits come out up to ~25 % shorter than nominal (still within the 1-wire spec)
+constexpr uint8_t VALUE_IPL_STATIC_PIN { VALUE_IPL };
+#if defined(EIFR) /* atmega: INTFn is bit n */
+#define DIRECT_CLEAR_INTERRUPT(pin)     (EIFR = static_cast<uint8_t>(1 << digitalPinToInterrupt(pin)))
+#elif defined(GIFR) && defined(INTF0) /* attiny: only INT0 */
+#define DIRECT_CLEAR_INTERRUPT(pin)     (GIFR = static_cast<uint8_t>(1 << INTF0))
+#endif
 
 #elif defined(__MK20DX128__) || defined(__MK20DX256__) || defined(__MK66FX1M0__) || defined(__MK64FX512__) /* teensy 3.2 to 3.6 */
 #define PIN_TO_BASEREG(pin)             (portOutputRegister(pin))
@@ -37,6 +56,9 @@ constexpr uint8_t VALUE_IPL {13}; // instructions per loop, compare 0 takes 11,
 #define DIRECT_WRITE_HIGH(base, mask)   (*((base)+128) = 1)
 using io_reg_t = uint8_t; // define special datatype for register-access
 constexpr uint8_t VALUE_IPL {8}; // instructions per loop
+#define ONEWIRE_CYCLE_COUNTER           1
+#define ONEWIRE_CYCLE_COUNT()           (ARM_DWT_CYCCNT)
+#define ONEWIRE_CYCLE_INIT()            do { ARM_DEMCR |= ARM_DEMCR_TRCENA; ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA; } while (0)
 
 #elif defined(__MKL26Z64__) /* teensy LC */
 
@@ -67,6 +89,9 @@ constexpr uint8_t VALUE_IPL {0}; // instructions per loop, uncalibrated so far -
 #endif
 using io_reg_t = uint32_t; // define special datatype for register-access
 constexpr uint8_t VALUE_IPL { 22 }; // instructions per loop, uncalibrated so far - see ./examples/debug/calibrate_by_bus_timing for an explanation
+#define ONEWIRE_CYCLE_COUNTER           1 // cortex-m3 has a DWT-unit
+#define ONEWIRE_CYCLE_COUNT()           (DWT->CYCCNT)
+#define ONEWIRE_CYCLE_INIT()            do { CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; } while (0)
 
 #elif defined(__PIC32MX__)
 
@@ -84,6 +109,9 @@ constexpr uint8_t VALUE_IPL { 0 }; // instructions per loop, uncalibrated so far
 
 #define PIN_TO_BASEREG(pin)             ((volatile uint32_t*) GPO)
 #define PIN_TO_BITMASK(pin)             (1 << pin)
+#define ONEWIRE_STATIC_PIN_SUPPORT      1
+#define PIN_TO_BASEREG_STATIC(pin)      ((volatile uint32_t*) GPO)
+#define PIN_TO_BITMASK_STATIC(pin)      (1UL << (pin))
 #define DIRECT_READ(base, mask)         ((GPI & (mask)) ? 1 : 0)    //GPIO_IN_ADDRESS
 #define DIRECT_MODE_INPUT(base, mask)   (GPE &= ~(mask))            //GPIO_ENABLE_W1TC_ADDRESS
 #define DIRECT_MODE_OUTPUT(base, mask)  (GPE |= (mask))             //GPIO_ENABLE_W1TS_ADDRESS
@@ -92,9 +120,92 @@ constexpr uint8_t VALUE_IPL { 0 }; // instructions per loop, uncalibrated so far
 using io_reg_t = uint32_t; // define special datatype for register-access
 // The ESP8266 has two possible CPU frequencies: 160 MHz (26 IPL) and 80 MHz (22 IPL) -> something influences the IPL-Value
 constexpr uint8_t VALUE_IPL { (microsecondsToClockCycles(1) > 120) ? 26 : 22 }; // instructions per loop
+constexpr uint8_t VALUE_IPL_STATIC_PIN { VALUE_IPL }; // GPI has a fixed address anyway, only the mask gets constant
+#define DIRECT_CLEAR_INTERRUPT(pin)     (GPIEC = (1UL << (pin)))    //GPIO_STATUS_W1TC_ADDRESS
+#define ONEWIRE_CYCLE_COUNTER           1
+#define ONEWIRE_CYCLE_COUNT()           (xtensaCycleCount())
+#if defined(IRAM_ATTR)
+#define ONEWIRE_IRAM_ATTR               IRAM_ATTR
+#else
+#define ONEWIRE_IRAM_ATTR               ICACHE_RAM_ATTR
+#endif
+#define ONEWIRE_ISR_ATTR                ONEWIRE_IRAM_ATTR           // core refuses ISRs that live in flash
+#define ONEWIRE_SLEEP_SUPPORT           1 // forced light sleep, gpio wake-up, needs the radio off and core >= 3.0
+constexpr uint32_t ONEWIRE_WAKE_LATENCY_US {5000}; // espressif states a few ms for light sleep, not measured, far above a reset
 
 #elif defined(ARDUINO_ARCH_ESP32) || defined(ESP32) /* ESP32 Family */
 
+#if !defined(CONFIG_IDF_TARGET) || defined(CONFIG_IDF_TARGET_ESP32) /* classic esp32: register-access, two banks (gpio 0-31, 32-39) */
+
+#include "soc/gpio_struct.h"
+
+#define PIN_TO_BASEREG(pin)             (0)
+#define PIN_TO_BITMASK(pin)             (pin)
+using io_reg_t = uint32_t; // define special data type for register-access
+constexpr uint8_t VALUE_IPL { 39 }; // instructions per loop, measured with digitalRead(), recalibrate if the cycle counter is disabled
+
+static inline __attribute__((always_inline))
+io_reg_t directRead(const io_reg_t pin)
+{
+    if (pin < 32)
+        return (GPIO.in >> pin) & 0x01;
+    return (GPIO.in1.val >> (pin - 32)) & 0x01;
+}
+
+static inline __attribute__((always_inline))
+void directWriteLow(const io_reg_t pin)
+{
+    if (pin < 32)
+        GPIO.out_w1tc = (static_cast<uint32_t>(1) << pin);
+    else
+        GPIO.out1_w1tc.val = (static_cast<uint32_t>(1) << (pin - 32));
+}
+
+static inline __attribute__((always_inline))
+void directWriteHigh(const io_reg_t pin)
+{
+    if (pin < 32)
+        GPIO.out_w1ts = (static_cast<uint32_t>(1) << pin);
+    else
+        GPIO.out1_w1ts.val = (static_cast<uint32_t>(1) << (pin - 32));
+}
+
+static inline __attribute__((always_inline))
+void directModeInput(const io_reg_t pin)
+{
+    if (pin < 32)
+        GPIO.enable_w1tc = (static_cast<uint32_t>(1) << pin);
+    else
+        GPIO.enable1_w1tc.val = (static_cast<uint32_t>(1) << (pin - 32));
+}
+
+static inline __attribute__((always_inline))
+void directModeOutput(const io_reg_t pin)
+{
+    if (pin < 32)
+        GPIO.enable_w1ts = (static_cast<uint32_t>(1) << pin);
+    else if (pin < 34) // 34 to 39 are input-only
+        GPIO.enable1_w1ts.val = (static_cast<uint32_t>(1) << (pin - 32));
+}
+
+static inline __attribute__((always_inline))
+void directClearInterrupt(const io_reg_t pin)
+{
+    if (pin < 32)
+        GPIO.status_w1tc = (static_cast<uint32_t>(1) << pin);
+    else
+        GPIO.status1_w1tc.val = (static_cast<uint32_t>(1) << (pin - 32));
+}
+
+#define DIRECT_READ(base, pin)          directRead(pin)
+#define DIRECT_WRITE_LOW(base, pin)     directWriteLow(pin)
+#define DIRECT_WRITE_HIGH(base, pin)    directWriteHigh(pin)
+#define DIRECT_MODE_INPUT(base, pin)    directModeInput(pin)
+#define DIRECT_MODE_OUTPUT(base, pin)   directModeOutput(pin)
+#define DIRECT_CLEAR_INTERRUPT(pin)     directClearInterrupt(pin)
+
+#else /* s2, s3, c3, ...: other register layout */
+
 #define PIN_TO_BASEREG(pin)             (0)
 #define PIN_TO_BITMASK(pin)             (pin)
 #define DIRECT_READ(base, pin)          digitalRead(pin)
@@ -102,10 +213,29 @@ constexpr uint8_t VALUE_IPL { (microsecondsToClockCycles(1) > 120) ? 26 : 22 };
 #define DIRECT_WRITE_HIGH(base, pin)    digitalWrite(pin, HIGH)
 #define DIRECT_MODE_INPUT(base, pin)    pinMode(pin, INPUT)
 #define DIRECT_MODE_OUTPUT(base, pin)   pinMode(pin,OUTPUT)
-#define DELAY_MICROSECONDS(us)		    delayMicroseconds(us)
 using io_reg_t = uint32_t; // define special data type for register-access
 constexpr uint8_t VALUE_IPL { 39 }; // instructions per loop, for 40 and 80 MHz (see esp8266 difference)
 
+#endif
+
+#define DELAY_MICROSECONDS(us)		    delayMicroseconds(us)
+#define ONEWIRE_STATIC_PIN_SUPPORT      1
+#define PIN_TO_BASEREG_STATIC(pin)      (nullptr)
+#define PIN_TO_BITMASK_STATIC(pin)      (pin)
+#define ONEWIRE_IRAM_ATTR               IRAM_ATTR
+#define ONEWIRE_ISR_ATTR                IRAM_ATTR
+#define ONEWIRE_MEMORY_BARRIER()        __sync_synchronize()        // dual core, the other one has to see the stores in order
+#define ONEWIRE_INTERRUPTS_OFF()        portDISABLE_INTERRUPTS()    // noInterrupts() of the arduino-core does nothing here
+#define ONEWIRE_INTERRUPTS_ON()         portENABLE_INTERRUPTS()     // only the current core, the other one runs on
+constexpr uint8_t VALUE_IPL_STATIC_PIN { VALUE_IPL };
+#if !defined(CONFIG_FREERTOS_UNICORE) && (portNUM_PROCESSORS > 1)
+#define ONEWIRE_TASK_SUPPORT            1 // OneWireHubTask: hub pinned to one core, the application on the other
+#endif
+#if defined(__XTENSA__) /* riscv-variants (c3) have no ccount-register */
+#define ONEWIRE_CYCLE_COUNTER           1
+#define ONEWIRE_CYCLE_COUNT()           (xtensaCycleCount())
+#endif
+
 #elif defined(__SAMD21G18A__) /* arduino zero */
 
 #define PIN_TO_BASEREG(pin)             portModeRegister(digitalPinToPort(pin))
@@ -238,6 +368,61 @@ void directWriteHigh(volatile io_reg_t *base, io_reg_t pin)
 #define DIRECT_WRITE_LOW(base, pin)	    directWriteLow(base, pin)
 #define DIRECT_WRITE_HIGH(base, pin)	directWriteHigh(base, pin)
 
+#elif defined(ONEWIREHUB_HOST) /* linux / pc: simulated open-drain bus with a virtual clock (see platform.cpp) */
+
+#include <inttypes.h>
+#include <stdio.h> // printf() of some items, the arduino-core offers it
+
+// the bitmask is the number of the simulated bus, the hub pulls it low with output-mode and a low latch
+#define PIN_TO_BASEREG(pin)             (0)
+#define PIN_TO_BITMASK(pin)             (pin)
+#define DIRECT_READ(base, pin)          hostWireRead(pin)
+#define DIRECT_MODE_INPUT(base, pin)    hostWireMode(pin, false)
+#define DIRECT_MODE_OUTPUT(base, pin)   hostWireMode(pin, true)
+#define DIRECT_WRITE_LOW(base, pin)     hostWireWrite(pin, false)
+#define DIRECT_WRITE_HIGH(base, pin)    hostWireWrite(pin, true)
+using io_reg_t = uint32_t; // define special datatype for register-access
+#define ONEWIRE_SLEEP_SUPPORT           1 // the clock runs until the bus falls, then adds the wake-up latency
+#ifndef HOST_WAKE_LATENCY_US
+#define HOST_WAKE_LATENCY_US            10
+#endif
+constexpr uint32_t ONEWIRE_WAKE_LATENCY_US {HOST_WAKE_LATENCY_US};
+constexpr uint8_t VALUE_IPL {20}; // each pin-poll advances the virtual clock by this many cycles (200 ns @ 100 MHz)
+#define ONEWIRE_CYCLE_COUNTER           1
+#define ONEWIRE_CYCLE_COUNT()           (hostClockCycles())
+#define DIRECT_CLEAR_INTERRUPT(pin)     hostClearInterrupt(pin)
+#define ONEWIRE_ISR_WAIT()              hostClockIdle()
+typedef bool boolean;
+
+// the virtual clock only moves when the hub polls the bus (or delay() is called), computation takes no bus-time
+uint32_t hostClockCycles(void);
+uint64_t hostClockTime(void);   // cycles since start, does not wrap
+void     hostClockAdvance(uint32_t cycles);
+
+// the master of a simulated bus is asked at every poll: it gets the time and the level the slaves produce,
+// it returns true while it pulls the bus low itself
+using HostMasterFn = bool (*)(void *context, uint64_t time_cycles, bool slave_level);
+void     hostWireAttachMaster(uint32_t pin, HostMasterFn master, void *context);
+
+// several hubs on one bus: each hub gets its own pin, the pin is connected to the bus (wired and)
+void     hostWireConnect(uint32_t pin, uint32_t bus_pin);
+
+// with a yield-fn every poll hands control to a scheduler that moves the clock (co-simulation),
+// without it each poll advances the clock by VALUE_IPL
+using HostYieldFn = void (*)(void);
+void     hostClockSetYield(HostYieldFn yield);
+void     hostClockIdle(void); // the loop does something else for one poll, the clock moves on and pending pin-interrupts run
+
+// pin-interrupts (attachInterrupt()) see the edges of the bus whenever the clock moves, unless they are masked.
+// an edge that happens inside the ISR stays pending until hostClearInterrupt() drops it, like a latched flag
+void     hostClearInterrupt(uint32_t pin);
+bool     hostInterruptsMasked(void); // noInterrupts() is in effect
+
+bool     hostWireLevel(uint32_t pin); // level of the bus without polling, time stands still
+bool     hostWireRead(uint32_t pin);
+void     hostWireMode(uint32_t pin, bool output);
+void     hostWireWrite(uint32_t pin, bool value);
+
 #else // any unknown architecture, including PC
 
 #include <inttypes.h>
@@ -256,6 +441,83 @@ constexpr uint8_t VALUE_IPL {10}; // instructions per loop, uncalibrated so far
 
 #endif
 
+#if defined(__XTENSA__)
+static inline __attribute__((always_inline))
+uint32_t xtensaCycleCount(void)
+{
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a" (ccount));
+    return ccount;
+}
+#endif
+
+#ifndef ONEWIRE_STATIC_PIN_SUPPORT
+#define ONEWIRE_STATIC_PIN_SUPPORT      0
+#endif
+
+// the avr-timers are not an option (timer0 ticks with 4 us @ 16 MHz), so it stays with counting loops there
+#ifndef ONEWIRE_CYCLE_COUNTER
+#define ONEWIRE_CYCLE_COUNTER           0
+#define ONEWIRE_CYCLE_COUNT()           (0)
+#endif
+
+#ifndef ONEWIRE_CYCLE_INIT
+#define ONEWIRE_CYCLE_INIT()
+#endif
+
+// timing-backend of the hub: 1 --> measure with the cycle counter of the cpu (exact and independent of compiler or cpu-speed),
+//                            0 --> count loops and convert with VALUE_IPL (needs calibration for every architecture)
+// the counter is only used if the architecture has one, otherwise the hub falls back to the loops
+#ifndef USE_CYCLE_COUNTER
+#define USE_CYCLE_COUNTER 1
+#endif
+
+#define HUB_CYCLE_TIMING ((USE_CYCLE_COUNTER != 0) && (ONEWIRE_CYCLE_COUNTER != 0))
+
+// timestamps of the edges in the interrupt-engine, same backend as above (micros() is safe within an ISR of the arduino-cores)
+#if HUB_CYCLE_TIMING
+#define ONEWIRE_ISR_CLOCK()             (ONEWIRE_CYCLE_COUNT())
+#else
+#define ONEWIRE_ISR_CLOCK()             (micros())
+#endif
+
+// the loop waits for the interrupt-engine to queue the next timeslot
+#ifndef ONEWIRE_ISR_WAIT
+#define ONEWIRE_ISR_WAIT()
+#endif
+
+// needed by the interrupt-engine of the hub: drop an edge-event that was already handled inside the ISR
+#ifndef DIRECT_CLEAR_INTERRUPT
+#define DIRECT_CLEAR_INTERRUPT(pin)
+#endif
+
+#ifndef ONEWIRE_ISR_ATTR
+#define ONEWIRE_ISR_ATTR
+#endif
+
+// low-power idle of the hub (USE_SLEEP): the mcu sleeps until the bus goes low or timeout_us passed (0: no timeout),
+// returns false if it could not sleep (bus low already, timeout too short for the platform)
+#ifndef ONEWIRE_SLEEP_SUPPORT
+#define ONEWIRE_SLEEP_SUPPORT           0
+#else
+bool sleepUntilBusLow(uint8_t pin_number, uint32_t timeout_us);
+#endif
+
+#ifndef ONEWIRE_TASK_SUPPORT
+#define ONEWIRE_TASK_SUPPORT            0
+#endif
+
+// single core: keeping the compiler from reordering is enough for the queues between ISR and loop()
+#ifndef ONEWIRE_MEMORY_BARRIER
+#define ONEWIRE_MEMORY_BARRIER()        __asm__ __volatile__("" ::: "memory")
+#endif
+
+// critical section of the hub (maskInterrupts() and the timeslots with MaskScope::SLOT)
+#ifndef ONEWIRE_INTERRUPTS_OFF
+#define ONEWIRE_INTERRUPTS_OFF()        noInterrupts()
+#define ONEWIRE_INTERRUPTS_ON()         interrupts()
+#endif
+
 
 
 /////////////////////////////////////////// EXTRA PART /////////////////////////////////////////
@@ -279,6 +541,10 @@ constexpr uint8_t VALUE_IPL {10}; // instructions per loop, uncalibrated so far
 #define OUTPUT 0
 #define HIGH 1
 #define LOW 0
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT (-1)
 
 
 static bool mockup_pin_value[256];
@@ -301,6 +567,19 @@ T1 * portInputRegister(const T1 port) { return port; };
 template<typename T1>
 T1 digitalPinToBitMask(const T1 pin) { return pin; };
 
+template<typename T1>
+int digitalPinToInterrupt(const T1 pin) { return pin; };
+
+#if defined(ONEWIREHUB_HOST)
+void attachInterrupt(int interrupt, void (*handler)(void), int mode); // interrupt is the pin, see platform.cpp
+void detachInterrupt(int interrupt);
+#else
+template<typename T1, typename T2>
+void attachInterrupt(const int /*interrupt*/, T1 /*handler*/, const T2 /*mode*/) { };
+
+inline void detachInterrupt(const int /*interrupt*/) { };
+#endif
+
 constexpr uint32_t microsecondsToClockCycles(const uint32_t micros) { return (100*micros); }; // mockup, emulate 100 MHz CPU
 
 template<typename T1>
@@ -337,7 +616,7 @@ T1 pgm_read_byte(const T1* address)
 #define HEX 2
 #endif
 
-static class serial
+class serial
 {
 private:
 
@@ -352,7 +631,9 @@ public:
     void flush() { };
     void begin(const uint32_t speed_baud) { speed = speed_baud; };
 
-} Serial;
+};
+
+extern serial Serial; // defined in platform.cpp
 
 
 template<typename T1, typename T2>
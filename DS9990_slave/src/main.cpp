@@ -14,12 +14,15 @@
 
 #define DEBUG_DISPLAY_DHT 1
 #define DEBUG 0
+#define SERVE_BY_INTERRUPT 0 // 1: the pin-interrupt handles the edges, loop() serves the transactions (needs USE_INTERRUPT_ENGINE), 0: hub.poll() busy-waits in loop()
 
 constexpr uint8_t pin_led{2};
 constexpr uint8_t pin_onewire{D1};
+constexpr uint32_t poll_budget_us{2000}; // longest wait for a reset in poll(), a transaction in progress is always finished
 
 uint32_t i_loop = 0;
 uint32_t lastDhtReading = -4000;
+constexpr uint32_t dht_read_us{300000}; // readDhtBlocking() takes ~250 ms, the master should stay away that long
 
 auto hub = OneWireHub(pin_onewire);
 
@@ -43,6 +46,8 @@ float t;
 
 bool blinking(void);
 
+volatile bool values_requested = false; // the master read the memory or the DHT has new values, refresh the memory
+
 #if 0
 void readDhtNonBlocking()
 {
@@ -93,6 +98,26 @@ void readDhtBlocking()
 #endif
 }
 
+// runs after the bus went idle, so keep it short
+void onDs9990Activity(OneWireItem &item, const OneWireActivity &activity)
+{
+  (void)item;
+
+  // the master wrote the brake byte
+  if ((activity.write_start == 0) && (activity.write_end != activity.write_start))
+  {
+    uint8_t brake;
+    ds9990.readMemory(&brake, 1, 0);
+
+    // apply brake output to LED and D6
+    digitalWrite(pin_led, brake);
+    digitalWrite(D6, brake);
+  }
+
+  if (activity.read)
+    values_requested = true;
+}
+
 void setValues()
 {
   uint8_t val[8];
@@ -112,9 +137,15 @@ void setup()
   pinMode(pin_led, OUTPUT);
   pinMode(D6, OUTPUT);
 
+  ds9990.setOverdrive(); // answers OVERDRIVE SKIP / MATCH ROM, only with -DOVERDRIVE_ENABLE=1 (off by default)
+  ds9990.setCallback(onDs9990Activity);
   hub.attach(ds9990);
   setValues();
 
+#if SERVE_BY_INTERRUPT
+  hub.startInterruptMode();
+#endif
+
   dht.begin();
 
   //Serial.println("config done");
@@ -123,10 +154,38 @@ void setup()
 void loop()
 {
   boolean hasProcessed = false;
+#if SERVE_BY_INTERRUPT
+  hasProcessed = hub.fetchProcessed();
+#elif USE_SLEEP
+  // light sleep only pays off if the master polls slower than ~10 ms, add -DUSE_SLEEP=1 to platformio.ini
+  hub.pollSleep(&hasProcessed);
+#else
   // following function must be called periodically
-  hub.poll(&hasProcessed);
+  hub.poll(&hasProcessed, poll_budget_us);
+#endif
   if (hasProcessed)
+    i_loop++;
+
+  // read temperature and humidity from DHT
+  // only block if the master is not expected to poll in the meantime, blindly only as long as no period is learned.
+  // a learned but unsteady period defers the reading to a later loop
+  if (millis() > lastDhtReading + 4000)
+  {
+    uint8_t confidence;
+    const uint32_t idle_us = hub.timeUntilNextExpectedReset(confidence);
+    if ((hub.getMasterPeriod() == 0) || ((confidence >= 128) && (idle_us > dht_read_us)))
+    {
+      //readDhtNonBlocking();
+      readDhtBlocking();
+      lastDhtReading = millis();
+      values_requested = true;
+    }
+  }
+
+  if (values_requested)
   {
+    values_requested = false;
+
     //Serial.printf("hasProcessed = %d / millis = %d\n", hasProcessed, millis());
 
     /*
@@ -135,21 +194,7 @@ void loop()
     hub.printError();
 */
 
-    // read received data from memory
     uint8_t val[8];
-    ds9990.readMemory(val, 7, 0);
-
-    // apply brake output to LED and D6
-    digitalWrite(pin_led, val[0]);
-    digitalWrite(D6, val[0]);
-
-    // read temperature and humidity from DHT
-    if (millis() > lastDhtReading + 4000)
-    {
-      //readDhtNonBlocking();
-      readDhtBlocking();
-      lastDhtReading = millis();
-    }
 
     int16_t temp_int = t * 10;
     int16_t hum_int = h * 10;
@@ -159,7 +204,7 @@ void loop()
     val[3] = hum_int & 0xff;
     val[4] = (hum_int >> 8) & 0xff;
 #if DEBUG
-    Serial.printf("millis = %d / A val[0] = %02x\n", millis(), val[0]);
+    Serial.printf("millis = %d / T = %d / H = %d\n", millis(), temp_int, hum_int);
 #endif
 
     // read current from A0
@@ -172,8 +217,6 @@ void loop()
 
     // write data in memory for next request
     ds9990.writeMemory(&val[1], 6, 1);
-
-    i_loop++;
   }
 }
 
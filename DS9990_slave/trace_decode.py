@@ -0,0 +1,50 @@
+# decodes the output of OneWireHub::printTrace() (see USE_TRACE in lib/OWB/OneWireHub_config.h)
+# and prints one timeline per transaction, starting with each reset
+#   python trace_decode.py monitor.log
+#   pio device monitor | python trace_decode.py
+import sys
+
+EVENTS = ("reset", "presence", "send", "recv", "duty-start", "duty-end")
+
+
+def decode(lines):
+    unit, mhz = "us", 1
+    transaction = []
+    previous = None
+
+    def flush():
+        if not transaction:
+            return
+        bits = "".join(str(value) for name, value, _, _ in transaction if name in ("send", "recv"))
+        print("--- transaction, %d bits: %s" % (len(bits), bits))
+        margin_unit = "us" if unit == "cycles" else "loops"
+        for name, value, delta, margin in transaction:
+            print("  %+10.1f us  %-10s %3d  margin %8.1f %s" % (delta, name, value, margin, margin_unit))
+        del transaction[:]
+
+    for line in lines:
+        fields = line.strip().split(",")
+        if fields[0] == "trace-unit" and len(fields) == 3:
+            unit, mhz = fields[1], max(int(fields[2]), 1)
+        elif fields[0] == "trace-dropped" and len(fields) == 2 and int(fields[1]) != 0:
+            print("!!! %s records were overwritten before they were read" % fields[1])
+        elif fields[0] == "trace" and len(fields) == 5:
+            event, value, time, loops = (int(field) for field in fields[1:])
+            name = EVENTS[event] if event < len(EVENTS) else "event-%d" % event
+            # the counters wrap at 32 bit
+            delta = 0.0 if previous is None else ((time - previous) & 0xFFFFFFFF) / (float(mhz) if unit == "cycles" else 1.0)
+            previous = time
+            # loops are cpu-cycles with the cycle counter, otherwise wait-loops of unknown length
+            margin = loops / float(mhz) if unit == "cycles" else float(loops)
+            if name == "reset" and value == 1:
+                flush()
+            transaction.append((name, value, delta, margin))
+    flush()
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 1:
+        with open(sys.argv[1]) as log:
+            decode(log)
+    else:
+        decode(sys.stdin)
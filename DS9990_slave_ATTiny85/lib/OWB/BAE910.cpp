@@ -10,7 +10,7 @@ BAE910::BAE910(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
 }
 
 
-void BAE910::duty(OneWireHub * const hub)
+ONEWIRE_HOT void BAE910::duty(OneWireHub * const hub)
 {
     uint8_t  cmd, ta1, ta2, len, eCmd; // command, targetAddress, length and extended command
     uint16_t crc { 0 };
@@ -5,13 +5,13 @@ DS2405::DS2405(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     pin_state = false;
 }
 
-void DS2405::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2405::duty(OneWireHub * const hub)
 {
     // IC uses weird bus-features to operate., match-rom is enough
     pin_state = !pin_state;
-    noInterrupts();
+    hub->maskInterrupts();
     while(!hub->sendBit(pin_state)); // if master issues read slots it gets the state...
-    interrupts();
+    hub->unmaskInterrupts();
 
     // TODO: when alarm search is implemented (0xEC):
     // when PIO pin is driven low this device issues an alarm, otherwise stays alarm is disabled
@@ -7,7 +7,7 @@ DS2438::DS2438(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     clearMemory();
 }
 
-void DS2438::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2438::duty(OneWireHub * const hub)
 {
     uint8_t page, cmd;
     if (hub->recv(&cmd))  return;
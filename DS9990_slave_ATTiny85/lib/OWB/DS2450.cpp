@@ -7,7 +7,7 @@ DS2450::DS2450(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5,
     clearMemory();
 }
 
-void DS2450::duty(OneWireHub * const hub)
+ONEWIRE_HOT void DS2450::duty(OneWireHub * const hub)
 {
     uint16_t reg_TA, crc = 0; // target address
     uint8_t  cmd;
@@ -58,9 +58,9 @@ void DS2450::duty(OneWireHub * const hub)
             crc = ~crc; // normally crc16 is sent ~inverted
             if (hub->send(reinterpret_cast<uint8_t *>(&crc),2)) return;
             // takes max 5.3 ms for 16 bit ( 4 CH * 16 bit * 80 us + 160 us per request = 5.3 ms )
-            noInterrupts();
+            hub->maskInterrupts();
             hub->sendBit(false); // still converting....
-            interrupts();
+            hub->unmaskInterrupts();
             break; // finished conversion: send 1, is passive ...
 
         default:
@@ -19,7 +19,7 @@ uint8_t DS9990::getCRC(uint8_t size)
     return crc8(memory, size);
 }
 
-void DS9990::duty(OneWireHub *const hub)
+ONEWIRE_HOT void DS9990::duty(OneWireHub *const hub)
 {
     uint8_t size_r, size_w, cmd, crc = 0; // Target address, redirected address, command, data, crc
     uint8_t temp[8];
@@ -35,14 +35,16 @@ void DS9990::duty(OneWireHub *const hub)
         if (hub->recv(&size_r, 1))
             return;
 
-        // hub->send(memory, size);
-        for (int i = 0; i < size_r; i++)
-        {
-            hub->send(memory[i]);
-        }
+        if (size_r > MEM_SIZE)
+            return; // would overread memory
+
+        if (hub->send(memory, size_r))
+            return;
 
         crc = crc8(memory, size_r, 0);
-        hub->send(crc);
+        if (hub->send(crc))
+            return;
+        markRead();
 
         //Serial.printf("read : memory[0] = %02x", memory[0]);
         //Serial.printf(" /// crc: %02x\n", crc);
@@ -54,6 +56,9 @@ void DS9990::duty(OneWireHub *const hub)
         if (hub->recv(&size_w, 1))
             return;
 
+        if (size_w > MEM_SIZE)
+            return; // would overrun temp
+
         if (hub->recv(temp, size_w))
             return;
 
@@ -64,6 +69,7 @@ void DS9990::duty(OneWireHub *const hub)
         if (crc == crc_rcv)
         {
             memcpy(memory, temp, size_w);
+            markWrite(0, size_w);
 
             if (hub->send(&crc))
                 return;
@@ -80,6 +86,9 @@ void DS9990::duty(OneWireHub *const hub)
         if (hub->recv(&size_w, 1))
             return;
 
+        if (size_w > MEM_SIZE)
+            return; // would overrun temp
+
         if (hub->recv(temp, size_w))
             return;
 
@@ -90,6 +99,7 @@ void DS9990::duty(OneWireHub *const hub)
         if (crc == crc_rcv)
         {
             memcpy(memory, temp, size_w);
+            markWrite(0, size_w);
 
             if (hub->send(&crc))
                 return;
@@ -99,14 +109,16 @@ void DS9990::duty(OneWireHub *const hub)
         if (hub->recv(&size_r, 1))
             return;
 
-        // hub->send(memory, size);
-        for (int i = 0; i < size_r; i++)
-        {
-            hub->send(memory[i]);
-        }
+        if (size_r > MEM_SIZE)
+            return; // would overread memory
+
+        if (hub->send(memory, size_r))
+            return;
 
         crc = crc8(memory, size_r, 0);
-        hub->send(crc);
+        if (hub->send(crc))
+            return;
+        markRead();
 
         //Serial.printf("write_read : memory[0] = %02x\n", memory[0]);
 
@@ -2,16 +2,76 @@
 #include "OneWireItem.h"
 
 #include "platform.h"
+#include "OneWireHub_crc.h"
+
+#if USE_INTERRUPT_ENGINE
+OneWireHub *OneWireHub::isr_hub = nullptr;
+
+constexpr uint8_t ISR_RX_RESET { 0x80 }; // element of isr_rx, the lower bits carry the generation
+#endif
+
+#if HUB_PIN_STATIC
+constexpr io_reg_t OneWireHub::pin_bitMask;
+#endif
 
 OneWireHub::OneWireHub(const uint8_t pin)
 {
     _error = Error::NO_ERROR;
 
+#if USE_INTERRUPT_ENGINE
+    isr_state         = IsrState::DISABLED;
+    isr_running       = false;
+    isr_bus_low       = false;
+    isr_slot_sent     = false;
+    isr_generation    = 0;
+    isr_fall_time     = 0;
+    isr_value         = 0;
+    isr_bitMask       = 0;
+    isr_transaction   = 0;
+    isr_reset_pending = 0;
+#endif
+
     slave_count = 0;
     slave_selected = nullptr;
+    slave_selected_number = 0;
+    activity_pending = false;
+    duty_cmd_pending = false;
+    mask_scope = MaskScope::CALL;
+    mask_depth = 0;
+    bus_idle = 0;
+    clearTelemetry();
+    resetTimingProfile();
+
+    period_burst_start = 0;
+    period_last_reset  = 0;
+    period_sample      = 0;
+    period_pending     = false;
+    period_average     = 0;
+    period_jitter      = 0;
+    period_samples     = 0;
+    period_outliers    = 0;
+
+#if USE_TRACE
+    trace_head = 0;
+    trace_tail = 0;
+    trace_dropped = 0;
+#endif
+
+    maskClear(slave_mask);
+    clearIDTree(idTree);
+#if USE_ALARM_SEARCH
+    maskClear(alarm_mask);
+    alarm_changes_seen = OneWireItem::alarm_changes; // attach() takes the alarm-flag as it is
+    clearIDTree(idTreeAlarm);
+#endif
 
 #if OVERDRIVE_ENABLE
     od_mode = false;
+    maskClear(od_mask);
+    clearIDTree(idTreeOverdrive);
+#if USE_ALARM_SEARCH
+    clearIDTree(idTreeOverdriveAlarm);
+#endif
 #endif
 
     for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
@@ -20,10 +80,13 @@ OneWireHub::OneWireHub(const uint8_t pin)
     }
 
     // prepare pin
+    pin_number  = pin;
+#if !HUB_PIN_STATIC
     pin_bitMask = PIN_TO_BITMASK(pin);
     pin_baseReg = PIN_TO_BASEREG(pin);
+#endif
     pinMode(pin, INPUT); // first port-access should by done by this FN, does more than DIRECT_MODE_....
-    DIRECT_WRITE_LOW(pin_baseReg, pin_bitMask);
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
 
     // prepare debug:
     if (USE_GPIO_DEBUG)
@@ -34,7 +97,9 @@ OneWireHub::OneWireHub(const uint8_t pin)
         DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
     }
 
-    static_assert(VALUE_IPL, "Your architecture has not been calibrated yet, please run examples/debug/calibrate_by_bus_timing and report instructions per loop (IPL) to https://github.com/orgua/OneWireHub");
+    ONEWIRE_CYCLE_INIT(); // the counter is off by default on some cortex-m
+
+    static_assert(HUB_CYCLE_TIMING || HUB_VALUE_IPL, "Your architecture has not been calibrated yet, please run examples/debug/calibrate_by_bus_timing and report instructions per loop (IPL) to https://github.com/orgua/OneWireHub");
     static_assert(ONEWIRE_TIME_VALUE_MIN > 2, "YOUR ARCHITECTURE IS TOO SLOW, THIS MAY RESULT IN TIMING-PROBLEMS"); // it could work though, never tested
 }
 
@@ -76,8 +141,18 @@ uint8_t OneWireHub::attach(OneWireItem &sensor)
         return 255;
 
     slave_list[position] = &sensor;
+    maskSet(slave_mask, position);
     slave_count++;
-    buildIDTree();
+    buildSearchStream(position);
+#if USE_ALARM_SEARCH
+    if (sensor.getAlarm())
+        maskSet(alarm_mask, position);
+#endif
+#if OVERDRIVE_ENABLE
+    if (sensor.getOverdrive())
+        maskSet(od_mask, position);
+#endif
+    insertIDTrees(position);
     return position;
 }
 
@@ -109,31 +184,33 @@ bool OneWireHub::detach(const uint8_t slave_number)
     if (slave_number >= ONEWIRESLAVE_LIMIT)
         return false;
 
+    removeIDTrees(slave_number);
+#if USE_ALARM_SEARCH
+    maskReset(alarm_mask, slave_number);
+#endif
+#if OVERDRIVE_ENABLE
+    maskReset(od_mask, slave_number);
+#endif
+
+    const OneWireItem *sensor = slave_list[slave_number];
     slave_list[slave_number] = nullptr;
+    maskReset(slave_mask, slave_number);
     slave_count--;
-    buildIDTree();
-
-    return true;
-}
 
-// just look through each bit of each ID and build a tree, so there are n=slaveCount decision-points
-// trade-off: more online calculation, but @4Slave 16byte storage instead of 3*256 byte
-uint8_t OneWireHub::getNrOfFirstBitSet(const mask_t mask) const
-{
-    mask_t _mask = mask;
+    // a slave with an identical ID was not part of the tree (the master can't distinguish them), it takes over now
     for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
     {
-        if ((_mask & 1) != 0)
-            return i;
-        _mask >>= 1;
+        if ((slave_list[i] != nullptr) && (memcmp(slave_list[i]->ID, sensor->ID, 8) == 0))
+            insertIDTrees(i);
     }
-    return 0;
+
+    return true;
 }
 
 // return next not empty element in slave-list
 uint8_t OneWireHub::getIndexOfNextSensorInList(const uint8_t index_start) const
 {
-    for (uint8_t i = index_start; i < ONEWIRE_TREE_SIZE; ++i)
+    for (uint8_t i = index_start; i < ONEWIRESLAVE_LIMIT; ++i)
     {
         if (slave_list[i] != nullptr)
             return i;
@@ -141,99 +218,284 @@ uint8_t OneWireHub::getIndexOfNextSensorInList(const uint8_t index_start) const
     return 0;
 }
 
-// gone through the address, store this result
-uint8_t OneWireHub::getNrOfFirstFreeIDTreeElement(void) const
+#if USE_ALARM_SEARCH
+// slaves that have their alarm-flag set
+mask_t OneWireHub::getAlarmMask(void) const
 {
-    for (uint8_t i = 0; i < ONEWIRE_TREE_SIZE; ++i)
+    mask_t mask_alarm;
+    maskClear(mask_alarm);
+
+    for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
     {
-        if (idTree[i].id_position == 255)
-            return i;
+        if ((slave_list[i] != nullptr) && slave_list[i]->getAlarm())
+            maskSet(mask_alarm, i);
     }
-    return 0;
+    return mask_alarm;
 }
 
-// initial FN to build the ID-Tree
-uint8_t OneWireHub::buildIDTree(void)
+#endif
+
+void OneWireHub::updateAlarms(void)
 {
-    mask_t mask_slaves = 0;
-    mask_t bit_mask = 0x01;
+#if USE_ALARM_SEARCH
+    const uint8_t changes = OneWireItem::alarm_changes;
+    if (changes == alarm_changes_seen)
+        return;
+    alarm_changes_seen = changes;
+
+    const mask_t mask_alarm = getAlarmMask();
+    if (maskIsEqual(mask_alarm, alarm_mask))
+        return;
 
-    // build mask
     for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
     {
-        if (slave_list[i] != nullptr)
-            mask_slaves |= bit_mask;
-        bit_mask <<= 1;
+        const bool alarm_new = maskTest(mask_alarm, i);
+        if (alarm_new == maskTest(alarm_mask, i))
+            continue;
+        removeIDTrees(i);
+        if (alarm_new)
+            maskSet(alarm_mask, i);
+        else
+            maskReset(alarm_mask, i);
+        insertIDTrees(i);
     }
+#endif
+}
 
-    for (uint8_t i = 0; i < ONEWIRE_TREE_SIZE; ++i)
+void OneWireHub::insertIDTrees(const uint8_t slave_number)
+{
+    insertIDTree(idTree, slave_number);
+#if USE_ALARM_SEARCH
+    if (maskTest(alarm_mask, slave_number))
+        insertIDTree(idTreeAlarm, slave_number);
+#endif
+#if OVERDRIVE_ENABLE
+    if (maskTest(od_mask, slave_number))
     {
-        idTree[i].id_position = 255;
+        insertIDTree(idTreeOverdrive, slave_number);
+#if USE_ALARM_SEARCH
+        if (maskTest(alarm_mask, slave_number))
+            insertIDTree(idTreeOverdriveAlarm, slave_number);
+#endif
     }
+#endif
+}
 
-    // begin with root-element
-    buildIDTree(0, mask_slaves); // goto branch
+void OneWireHub::removeIDTrees(const uint8_t slave_number)
+{
+    removeIDTree(idTree, slave_number);
+#if OVERDRIVE_ENABLE
+    removeIDTree(idTreeOverdrive, slave_number);
+#endif
+#if USE_ALARM_SEARCH
+    removeIDTree(idTreeAlarm, slave_number);
+#if OVERDRIVE_ENABLE
+    removeIDTree(idTreeOverdriveAlarm, slave_number);
+#endif
+#endif
+}
 
-    return 0;
+ONEWIRE_HOT const OneWireHub::IDTree &OneWireHub::getIDTree(const bool alarm) const
+{
+#if USE_ALARM_SEARCH
+#if OVERDRIVE_ENABLE
+    if (od_mode)
+        return alarm ? idTreeOverdriveAlarm : idTreeOverdrive;
+#endif
+    return alarm ? idTreeAlarm : idTree;
+#else
+    (void) alarm; // ALARM SEARCH is not answered
+#if OVERDRIVE_ENABLE
+    if (od_mode)
+        return idTreeOverdrive;
+#endif
+    return idTree;
+#endif
 }
 
-// returns the branch that this iteration has worked on
-uint8_t OneWireHub::buildIDTree(uint8_t position_IDBit, const mask_t mask_slaves)
+ONEWIRE_HOT mask_t OneWireHub::getSpeedMask(void) const
 {
-    if (mask_slaves == 0)
-        return (255);
+#if OVERDRIVE_ENABLE
+    if (od_mode)
+        return od_mask;
+#endif
+    return slave_mask;
+}
 
-    while (position_IDBit < 64)
+ONEWIRE_HOT bool OneWireHub::useGpioDebug(void) const
+{
+    return USE_GPIO_DEBUG && (GPIO_DEBUG_OVERDRIVE || !od_mode);
+}
+
+// the search shifts out SEARCH_BITS_PER_BYTE ID-bits per byte of this stream
+void OneWireHub::buildSearchStream(const uint8_t slave_number)
+{
+#if USE_SEARCH_STREAM
+    for (uint8_t position_IDBit = 0; position_IDBit < 64; ++position_IDBit)
     {
-        mask_t mask_pos{0};
-        mask_t mask_neg{0};
-        const uint8_t pos_byte{static_cast<uint8_t>(position_IDBit >> 3)};
-        const uint8_t mask_bit{static_cast<uint8_t>(1 << (position_IDBit & 7))};
-        mask_t mask_id{1};
+        const uint8_t pair  = getIDBit(slave_number, position_IDBit) ? uint8_t(0b01) : uint8_t(0b10);
+        const uint8_t shift = static_cast<uint8_t>((position_IDBit % SEARCH_BITS_PER_BYTE) * 2);
+        if (shift == 0)
+            search_stream[slave_number][position_IDBit / SEARCH_BITS_PER_BYTE] = 0;
+        search_stream[slave_number][position_IDBit / SEARCH_BITS_PER_BYTE] |= static_cast<uint8_t>(pair << shift);
+    }
+#else
+    (void) slave_number; // ID is used directly
+#endif
+}
 
-        // searchIDTree through all active slaves
-        for (uint8_t id = 0; id < ONEWIRESLAVE_LIMIT; ++id)
-        {
-            if ((mask_slaves & mask_id) != 0)
-            {
-                // if slave is in mask differentiate the bitValue
-                if ((slave_list[id]->ID[pos_byte] & mask_bit) != 0)
-                    mask_pos |= mask_id;
-                else
-                    mask_neg |= mask_id;
-            }
-            mask_id <<= 1;
-        }
+ONEWIRE_HOT const uint8_t *OneWireHub::getSearchStream(const uint8_t slave_number) const
+{
+#if USE_SEARCH_STREAM
+    return search_stream[slave_number];
+#else
+    return slave_list[slave_number]->ID;
+#endif
+}
 
-        if ((mask_neg != 0) && (mask_pos != 0))
-        {
-            // there was found a junction
-            const uint8_t active_element = getNrOfFirstFreeIDTreeElement();
+bool OneWireHub::getIDBit(const uint8_t slave_number, const uint8_t position_IDBit) const
+{
+    return ((slave_list[slave_number]->ID[position_IDBit >> 3] >> (position_IDBit & 7)) & 1) != 0;
+}
 
-            idTree[active_element].id_position = position_IDBit;
-            idTree[active_element].slave_selected = getNrOfFirstBitSet(mask_slaves);
-            position_IDBit++;
-            idTree[active_element].got_one = buildIDTree(position_IDBit, mask_pos);
-            idTree[active_element].got_zero = buildIDTree(position_IDBit, mask_neg);
-            return active_element;
-        }
+// returns position_end if both IDs are equal in the range
+uint8_t OneWireHub::getNrOfFirstDifferentIDBit(const uint8_t slave_a, const uint8_t slave_b, uint8_t position_IDBit, const uint8_t position_end) const
+{
+    while (position_IDBit < position_end)
+    {
+        if (getIDBit(slave_a, position_IDBit) != getIDBit(slave_b, position_IDBit))
+            break;
+        position_IDBit++;
+    }
+    return position_IDBit;
+}
+
+// all elements go into the free-list, it is linked by got_zero
+void OneWireHub::clearIDTree(IDTree &tree)
+{
+    for (tree_t i = 0; i < ONEWIRE_TREE_SIZE; ++i)
+    {
+        tree.element[i].id_position = 255;
+        tree.element[i].got_zero = (i + 1 < ONEWIRE_TREE_SIZE) ? static_cast<tree_t>(i + 1) : ID_TREE_NONE;
+        tree.element[i].got_one = ID_TREE_NONE;
+    }
+    tree.root = ID_TREE_NONE;
+    tree.free = 0;
+}
+
+// follow the path of the new ID until it leaves the tree, there a junction gets inserted
+// note: each junction references a slave of its branch, the bits between two junctions are taken from it
+void OneWireHub::insertIDTree(IDTree &tree, const uint8_t slave_number)
+{
+    tree_t *link = &tree.root;
+    uint8_t position_IDBit = 0;
+
+    while (*link != ID_TREE_NONE)
+    {
+        IDTreeElement &element = tree.element[*link];
+        const bool    is_leaf = (element.id_position > 63);
+        const uint8_t position_end = is_leaf ? uint8_t(64) : element.id_position;
+
+        position_IDBit = getNrOfFirstDifferentIDBit(slave_number, element.slave_selected, position_IDBit, position_end);
+
+        if (position_IDBit < position_end)
+            break; // ID leaves the branch here
+
+        if (is_leaf)
+            return; // already in tree (or an identical ID)
 
+        link = getIDBit(slave_number, position_IDBit) ? &element.got_one : &element.got_zero;
         position_IDBit++;
     }
 
-    // gone through the address, store this result
-    uint8_t active_element = getNrOfFirstFreeIDTreeElement();
+    if (tree.free == ID_TREE_NONE)
+        return; // can't happen, tree has room for 2 * HUB_SLAVE_LIMIT - 1 elements
 
-    idTree[active_element].id_position = 128;
-    idTree[active_element].slave_selected = getNrOfFirstBitSet(mask_slaves);
-    idTree[active_element].got_one = 255;
-    idTree[active_element].got_zero = 255;
+    const tree_t leaf = tree.free;
+    tree.free = tree.element[leaf].got_zero;
+    tree.element[leaf].id_position = 128;
+    tree.element[leaf].slave_selected = slave_number;
+    tree.element[leaf].got_zero = ID_TREE_NONE;
+    tree.element[leaf].got_one = ID_TREE_NONE;
 
-    return active_element;
+    if (*link == ID_TREE_NONE)
+    {
+        *link = leaf; // empty tree
+        return;
+    }
+
+    const tree_t junction = tree.free;
+    tree.free = tree.element[junction].got_zero;
+    const tree_t branch = *link;
+    tree.element[junction].id_position = position_IDBit;
+    tree.element[junction].slave_selected = tree.element[branch].slave_selected;
+    if (getIDBit(slave_number, position_IDBit))
+    {
+        tree.element[junction].got_one = leaf;
+        tree.element[junction].got_zero = branch;
+    }
+    else
+    {
+        tree.element[junction].got_one = branch;
+        tree.element[junction].got_zero = leaf;
+    }
+    *link = junction;
 }
 
-bool OneWireHub::poll(boolean *hasProcessed)
+// the leaf and its junction get freed, the sibling branch takes the place of the junction
+void OneWireHub::removeIDTree(IDTree &tree, const uint8_t slave_number)
 {
+    tree_t *link_parent = nullptr;
+    tree_t *link = &tree.root;
+
+    while (*link != ID_TREE_NONE)
+    {
+        IDTreeElement &element = tree.element[*link];
+        if (element.id_position > 63)
+            break;
+        link_parent = link;
+        link = getIDBit(slave_number, element.id_position) ? &element.got_one : &element.got_zero;
+    }
+
+    const tree_t leaf = *link;
+    if ((leaf == ID_TREE_NONE) || (tree.element[leaf].slave_selected != slave_number))
+        return; // not in tree
+
+    tree.element[leaf].id_position = 255;
+    tree.element[leaf].got_zero = tree.free;
+    tree.free = leaf;
+
+    if (link_parent == nullptr)
+    {
+        tree.root = ID_TREE_NONE;
+        return;
+    }
+
+    const tree_t junction = *link_parent;
+    const tree_t sibling = (link == &tree.element[junction].got_one) ? tree.element[junction].got_zero : tree.element[junction].got_one;
+    *link_parent = sibling;
+
+    tree.element[junction].id_position = 255;
+    tree.element[junction].got_zero = tree.free;
+    tree.free = junction;
+
+    // junctions above that referenced the removed slave switch to the sibling-branch
+    const uint8_t slave_replace = tree.element[sibling].slave_selected;
+    tree_t position = tree.root;
+    while (position != sibling)
+    {
+        IDTreeElement &element = tree.element[position];
+        if (element.slave_selected == slave_number)
+            element.slave_selected = slave_replace;
+        position = getIDBit(slave_number, element.id_position) ? element.got_one : element.got_zero;
+    }
+}
+
+ONEWIRE_HOT bool OneWireHub::poll(boolean *hasProcessed)
+{
+    if (isrActive())
+        return false; // interrupt-engine is in charge of the bus
+
     _error = Error::NO_ERROR;
 
     while (true)
@@ -242,17 +504,28 @@ bool OneWireHub::poll(boolean *hasProcessed)
         if (slave_count == 0)
             return true;
 
+        updateAlarms();
+
         //Once reset is done, go to next step
         if (checkReset())
+        {
+            recordError();
+            if (bus_idle >= ONEWIRE_TIME_RESET_TIMEOUT)
+                runCallbacks(); // no reset in sight, the bus is idle (and not just between two timeslots)
             return false;
+        }
 
         // Reset is complete, tell the master we are present
         if (showPresence())
+        {
+            recordError();
             return false;
+        }
 
         //Now that the master should know we are here, we will get a command from the master
         if (recvAndProcessCmd())
         {
+            recordError();
             return false;
         }
         else
@@ -264,7 +537,489 @@ bool OneWireHub::poll(boolean *hasProcessed)
     }
 }
 
-bool OneWireHub::checkReset(void) // there is a specific high-time needed before a reset may occur -->  >120us
+ONEWIRE_HOT uint32_t OneWireHub::poll(boolean *hasProcessed, const uint32_t budget_us)
+{
+    if (isrActive() || (slave_count == 0))
+        return 0;
+
+    const uint32_t time_start = micros();
+
+    // the reset that ended the last transaction is still to be served
+    if (_error != Error::RESET_IN_PROGRESS)
+        _error = Error::NO_ERROR;
+
+    updateAlarms();
+
+    // only the wait for a reset can be cut short, the transaction itself has to be served in one go
+    const uint32_t time_used   = micros() - time_start;
+    const uint32_t time_left   = (budget_us > time_used) ? (budget_us - time_used) : 0;
+    const timeOW_t time_budget = timeUsToLoops(static_cast<uint16_t>((time_left < 0xFFFF) ? time_left : 0xFFFF));
+    const timeOW_t timeout     = (time_budget < ONEWIRE_TIME_RESET_TIMEOUT) ? time_budget : ONEWIRE_TIME_RESET_TIMEOUT;
+
+    if (checkReset(timeout))
+    {
+        recordError();
+        if (bus_idle >= ONEWIRE_TIME_RESET_TIMEOUT)
+            runCallbacks(); // no reset in sight, the bus is idle (and not just between two timeslots)
+    }
+    else if (showPresence() || recvAndProcessCmd())
+    {
+        recordError();
+    }
+    else
+    {
+        *hasProcessed = true;
+    }
+
+    return (micros() - time_start);
+}
+
+// the caller (e.g. OneWireHubGroup) has seen the falling edge already, serve a reset and the following transaction
+ONEWIRE_HOT bool OneWireHub::pollFallingEdge(boolean *hasProcessed, const uint16_t time_low_us)
+{
+    if (isrActive())
+        return false; // interrupt-engine is in charge of the bus
+
+    _error = Error::NO_ERROR;
+
+    if (slave_count == 0)
+        return false;
+
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
+    bus_idle = 0;
+
+    if (checkResetLow(timeUsToLoops(time_low_us)))
+    {
+        recordError();
+        return false; // just a timeslot of another transaction
+    }
+
+    while (true)
+    {
+        if (showPresence() || recvAndProcessCmd())
+        {
+            recordError();
+            return true;
+        }
+
+        *hasProcessed = true;
+
+        // only stay if the next reset started already, a new one has to be found by the caller
+        if (_error != Error::RESET_IN_PROGRESS)
+            return true;
+
+        if (checkReset())
+        {
+            recordError();
+            return true;
+        }
+    }
+}
+
+#if USE_SLEEP && ONEWIRE_SLEEP_SUPPORT
+ONEWIRE_HOT bool OneWireHub::pollSleep(boolean *hasProcessed)
+{
+    if (isrActive() || (slave_count == 0))
+        return false;
+
+    // the bus is busy: the reset that ended the last transaction is still to be served or a transaction runs
+    if ((_error == Error::RESET_IN_PROGRESS) || !DIRECT_READ(pinBaseReg(), pin_bitMask))
+    {
+        poll(hasProcessed, ONEWIRE_WAKE_LATENCY_US + 2 * SLEEP_GUARD_US);
+        return false;
+    }
+
+    updateAlarms();
+    runCallbacks(); // the bus is idle, the mcu will not get back here before the next transaction
+
+    bool slept = false;
+    if (ONEWIRE_WAKE_LATENCY_US <= SLEEP_EDGE_LATENCY_MAX_US)
+    {
+        slept = sleepUntilBusLow(pin_number, 0);
+    }
+    else
+    {
+        uint8_t confidence = 0;
+        const uint32_t time_idle = timeUntilNextExpectedReset(confidence);
+        if ((confidence >= SLEEP_CONFIDENCE) && (time_idle > (ONEWIRE_WAKE_LATENCY_US + SLEEP_GUARD_US)))
+            slept = sleepUntilBusLow(pin_number, time_idle - ONEWIRE_WAKE_LATENCY_US - SLEEP_GUARD_US);
+    }
+
+    if (slept && !DIRECT_READ(pinBaseReg(), pin_bitMask))
+    {
+        // woken by the edge: the low state started one wake-up ago. a slow wake-up can't tell when it started
+        constexpr uint16_t time_low_us = (ONEWIRE_WAKE_LATENCY_US <= SLEEP_EDGE_LATENCY_MAX_US) ? ONEWIRE_WAKE_LATENCY_US : 0;
+        pollFallingEdge(hasProcessed, time_low_us);
+    }
+    else
+    {
+        // woken by the timer ahead of the master or the sleep was not possible
+        poll(hasProcessed, ONEWIRE_WAKE_LATENCY_US + 2 * SLEEP_GUARD_US);
+    }
+    return slept;
+}
+#endif
+
+// a transaction ends regularly with the next reset (RESET_IN_PROGRESS) or when the master stops sending timeslots
+ONEWIRE_HOT bool OneWireHub::sniff(OneWireSniffQueue &queue)
+{
+    if (isrActive())
+        return false; // interrupt-engine is in charge of the bus
+
+    _error = Error::NO_ERROR;
+    bool pushed = false;
+
+    while (true)
+    {
+        if (checkReset())
+            return pushed;
+
+        OneWireSniffRecord record;
+        record.time = micros();
+        record.rom_cmd = 0;
+        record.data_size = 0;
+        for (uint8_t i = 0; i < 8; ++i)
+            record.id[i] = 0;
+
+        // other slaves pull low after the reset, the hub stays quiet
+        record.presence = 0;
+        if (waitLoopsWhilePinIs(ONEWIRE_TIME_SLOT_MAX[0], true) != 0)
+        {
+            record.presence = 1;
+            waitLoopsWhilePinIs(ONEWIRE_TIME_PRESENCE_MAX[0], false);
+        }
+
+        if (!recv(&record.rom_cmd))
+        {
+            switch (record.rom_cmd)
+            {
+            case 0xF0: // SEARCH ROM
+            case 0xEC: // ALARM SEARCH
+                // each bit: bit and complement of the slaves, then the direction chosen by the master
+                for (uint8_t position_IDBit = 0; position_IDBit < 64; ++position_IDBit)
+                {
+                    noInterrupts();
+                    recvBit();
+                    recvBit();
+                    const bool direction = recvBit();
+                    interrupts();
+                    if (_error != Error::NO_ERROR)
+                        break;
+                    if (direction)
+                        record.id[position_IDBit >> 3] |= static_cast<uint8_t>(1 << (position_IDBit & 7));
+                }
+                break;
+
+            case 0x55: // MATCH ROM
+            case 0x33: // READ ROM
+            case 0x0F: // OLD READ ROM
+                recv(record.id, 8);
+                break;
+
+            case 0x69: // OVERDRIVE MATCH ROM
+            case 0x3C: // OVERDRIVE SKIP ROM
+                break; // the following timeslots are too short to be sampled, the next regular reset ends them
+
+            default: // SKIP ROM, RESUME and unknown commands are followed by data directly
+                break;
+            }
+
+            // data of the function-command, until the next reset
+            while ((_error == Error::NO_ERROR) && (record.rom_cmd != 0x69) && (record.rom_cmd != 0x3C))
+            {
+                uint8_t value;
+                if (recv(&value))
+                    break;
+                if (record.data_size < SNIFFER_DATA_SIZE)
+                    record.data[record.data_size] = value;
+                if (record.data_size < 255)
+                    record.data_size++;
+            }
+        }
+
+        record.duration = micros() - record.time;
+        // the master going idle between bytes is a regular end as well
+        const bool regular_end = (_error == Error::RESET_IN_PROGRESS) || (_error == Error::FIRST_BIT_OF_BYTE_TIMEOUT);
+        record.error = regular_end ? Error::NO_ERROR : _error;
+        if (queue.push(record))
+            pushed = true;
+
+        // a reset started already, checkReset() takes care of it
+        if (_error != Error::RESET_IN_PROGRESS)
+        {
+            if (!regular_end)
+                recordError();
+            return pushed;
+        }
+    }
+}
+
+ONEWIRE_HOT bool OneWireHub::getPinState(void) const
+{
+    return DIRECT_READ(pinBaseReg(), pin_bitMask);
+}
+
+void OneWireHub::runCallbacks(void)
+{
+    if (!activity_pending)
+        return;
+    activity_pending = false;
+
+    for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
+    {
+        if (slave_list[i] != nullptr)
+            slave_list[i]->runCallback();
+    }
+}
+
+#if USE_INTERRUPT_ENGINE
+bool OneWireHub::startInterruptMode(void)
+{
+    if ((isr_hub != nullptr) && (isr_hub != this))
+        return false;
+
+    const int interrupt_number = digitalPinToInterrupt(pin_number);
+    if (interrupt_number == NOT_AN_INTERRUPT)
+        return false; // e.g. attiny85 only offers INT0 on pin 2
+
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
+
+    // leftovers of an earlier run: the loop drops the bits, the ISR drops the answers of the old generation
+    uint8_t element;
+    while (isr_rx.pop(element));
+    isr_rx.fetchDropped();
+    isr_generation = static_cast<uint8_t>((isr_generation + 1) & 0x7F);
+
+    isr_hub           = this;
+    isr_bus_low       = !DIRECT_READ(pinBaseReg(), pin_bitMask);
+    isr_fall_time     = ONEWIRE_ISR_CLOCK();
+    isr_slot_sent     = true; // a low state in progress is no bit
+    isr_bitMask       = 0;
+    isr_reset_pending = 0;
+    isr_state         = IsrState::ACTIVE;
+    attachInterrupt(interrupt_number, isrHandler, CHANGE);
+    return true;
+}
+
+void OneWireHub::stopInterruptMode(void)
+{
+    if (isr_hub != this)
+        return;
+
+    detachInterrupt(digitalPinToInterrupt(pin_number));
+    isr_state = IsrState::DISABLED;
+    isr_hub   = nullptr;
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
+}
+
+// the loop-part of the interrupt-engine: every reset the ISR queued starts a transaction, rom-command and duty() of the
+// items run here like in poll(), their timeslots come from the queues. bits without a reset belong to other slaves
+bool OneWireHub::fetchProcessed(void)
+{
+    if (isr_state == IsrState::DISABLED)
+        return false;
+
+    bool processed = false;
+    while (true)
+    {
+        uint8_t element = isr_reset_pending;
+        isr_reset_pending = 0;
+        while ((element & ISR_RX_RESET) == 0)
+        {
+            if (!isr_rx.pop(element))
+            {
+                runCallbacks(); // the bus may be busy with other slaves, but the items are only touched by the loop
+                return processed;
+            }
+        }
+
+        isr_rx.fetchDropped(); // the loop was too late for a transaction before, this one is complete
+        isr_transaction = static_cast<uint8_t>(element & ~ISR_RX_RESET);
+        _error = Error::NO_ERROR;
+        updateAlarms();
+        if (recvAndProcessCmd())
+            recordError();
+        else
+            processed = true;
+    }
+}
+
+ONEWIRE_ISR_ATTR void OneWireHub::isrHandler(void)
+{
+    if (isr_hub != nullptr)
+        isr_hub->isrEdge();
+}
+
+// interrupt-engine, entered on both edges of the bus. the low state between them is a bit or a reset
+// INFO: the ISR only stays on the bus to pull the zero of a read-slot (ONEWIRE_TIME_WRITE_ZERO) or to show the presence,
+//       the commands are left to fetchProcessed() and duty() never runs in here
+ONEWIRE_HOT void OneWireHub::isrEdge(void)
+{
+    if (isr_state == IsrState::DISABLED)
+        return;
+
+    const uint32_t time_now = ONEWIRE_ISR_CLOCK();
+    isr_running = true;
+    isrEdgeDecode(time_now);
+    isr_running = false;
+}
+
+ONEWIRE_HOT void OneWireHub::isrEdgeDecode(const uint32_t time_now)
+{
+    if (!isr_bus_low)
+    {
+        isr_bus_low   = true;
+        isr_fall_time = time_now;
+        isr_slot_sent = isrAnswerSlot();
+        if (!DIRECT_READ(pinBaseReg(), pin_bitMask))
+            return; // the rising edge triggers the ISR again
+        DIRECT_CLEAR_INTERRUPT(pin_number); // the master released the bus already, the rising edge is handled right here
+    }
+    isr_bus_low = false;
+
+    const uint32_t time_low = time_now - isr_fall_time;
+
+    if (time_low < ONEWIRE_ISR_RESET_MIN[od_mode])
+    {
+        if (isr_slot_sent)
+            return;
+
+        const bool bit_value = (time_low < ONEWIRE_ISR_READ_MIN[od_mode]);
+        isr_rx.push(bit_value ? 1 : 0);
+
+#if OVERDRIVE_ENABLE
+        // the master switches the speed right after the rom-command, the loop would be too late for the next timeslot
+        if (isr_bitMask != 0)
+        {
+            if (bit_value)
+                isr_value |= isr_bitMask;
+            isr_bitMask <<= 1;
+            if ((isr_bitMask == 0) && ((isr_value == 0x69) || (isr_value == 0x3C)) && !maskIsEmpty(od_mask))
+                od_mode = true;
+        }
+#endif
+        return;
+    }
+
+    if (time_low > ONEWIRE_ISR_RESET_MAX)
+    {
+        trace(TraceEvent::RESET, 0, 0);
+        return; // bus was stuck low
+    }
+
+#if OVERDRIVE_ENABLE
+    if (od_mode && (time_low >= ONEWIRE_ISR_RESET_MIN[0]))
+        od_mode = false; // normal reset detected, so leave OD-Mode
+#endif
+    recordReset();
+    trace(TraceEvent::RESET, 1, 0);
+
+    isr_generation = static_cast<uint8_t>((isr_generation + 1) & 0x7F);
+    isr_rx.push(static_cast<uint8_t>(ISR_RX_RESET | isr_generation));
+    isr_value   = 0;
+    isr_bitMask = 0x01;
+
+    pulsePresence(); // a bus stuck low shows up as the next reset, _error belongs to the loop
+
+    // the edges of the presence (own and from other slaves) were handled inside the ISR
+    DIRECT_CLEAR_INTERRUPT(pin_number);
+}
+
+// falling edge: a read-slot if the loop queued a bit, a zero is held on the bus. bits of an older transaction are dropped
+ONEWIRE_HOT bool OneWireHub::isrAnswerSlot(void)
+{
+    uint8_t element;
+    do
+    {
+        if (!isr_tx.pop(element))
+            return false;
+    }
+    while ((element >> 1) != isr_generation);
+
+    if ((element & 0x01) == 0)
+    {
+        DIRECT_MODE_OUTPUT(pinBaseReg(), pin_bitMask);
+        waitLoopsWhilePinIs(ONEWIRE_TIME_WRITE_ZERO[od_mode], false);
+        DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
+    }
+    return true;
+}
+
+// the loop queues the bit, the ISR puts it on the bus when the master starts the read-slot
+ONEWIRE_HOT bool OneWireHub::isrSendBit(const bool value)
+{
+    const bool late = (isr_rx.getCount() != 0);
+    if (isr_generation != isr_transaction)
+    {
+        _error = Error::RESET_IN_PROGRESS;
+        return true;
+    }
+    if (late)
+    {
+        _error = Error::WRITE_TIMESLOT_TIMEOUT; // the master wrote (or read) a slot the loop had no answer for yet
+        return true;
+    }
+
+    const uint32_t time_start = micros();
+    while (isr_tx.getCount() >= ISR_QUEUE_SIZE)
+    {
+        if ((micros() - time_start) > ONEWIRE_ISR_TIMEOUT_US)
+        {
+            _error = Error::AWAIT_TIMESLOT_TIMEOUT_HIGH;
+            return true;
+        }
+        ONEWIRE_ISR_WAIT();
+    }
+    isr_tx.push(static_cast<uint8_t>((value ? 1 : 0) | (isr_transaction << 1)));
+    return false;
+}
+
+ONEWIRE_HOT bool OneWireHub::isrRecvBit(void)
+{
+    const uint32_t time_start = micros();
+    uint8_t element;
+    while (!isr_rx.pop(element))
+    {
+        if ((micros() - time_start) > ONEWIRE_ISR_TIMEOUT_US)
+        {
+            _error = Error::AWAIT_TIMESLOT_TIMEOUT_HIGH;
+            return false;
+        }
+        ONEWIRE_ISR_WAIT();
+    }
+
+    if ((element & ISR_RX_RESET) != 0)
+    {
+        isr_reset_pending = element; // starts the next transaction in fetchProcessed()
+        _error = Error::RESET_IN_PROGRESS;
+        return false;
+    }
+    if (isr_tx.getCount() != 0)
+    {
+        _error = Error::WRITE_TIMESLOT_TIMEOUT; // the master wrote while bits for its read-slots were queued
+        return false;
+    }
+    if (isr_rx.fetchDropped() != 0)
+    {
+        _error = Error::READ_TIMESLOT_TIMEOUT; // the loop fell more than ISR_QUEUE_SIZE bits behind
+        return false;
+    }
+
+    return (element != 0);
+}
+#endif
+
+ONEWIRE_HOT bool OneWireHub::isrActive(void) const
+{
+#if USE_INTERRUPT_ENGINE
+    return (isr_state != IsrState::DISABLED);
+#else
+    return false;
+#endif
+}
+
+ONEWIRE_HOT bool OneWireHub::checkReset(const timeOW_t timeout) // there is a specific high-time needed before a reset may occur -->  >120us
 {
     static_assert(ONEWIRE_TIME_RESET_MIN[0] > (ONEWIRE_TIME_SLOT_MAX[0] + ONEWIRE_TIME_READ_MAX[0]), "Timings are wrong"); // last number should read: max(ONEWIRE_TIME_WRITE_ZERO,ONEWIRE_TIME_READ_MAX)
     static_assert(ONEWIRE_TIME_READ_MAX[0] > ONEWIRE_TIME_WRITE_ZERO[0], "switch ONEWIRE_TIME_WRITE_ZERO with ONEWIRE_TIME_READ_MAX in checkReset(), because it is bigger (worst case)");
@@ -275,38 +1030,56 @@ bool OneWireHub::checkReset(void) // there is a specific high-time needed before
     static_assert(ONEWIRE_TIME_RESET_MAX[0] > ONEWIRE_TIME_RESET_MIN[1], "Timings are wrong");
 #endif
 
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
+
+    const timeOW_t idle_before = bus_idle;
+    bus_idle = 0;
 
     // is entered if there are two resets within a given time (timeslot-detection can issue this skip)
     if (_error == Error::RESET_IN_PROGRESS)
     {
         _error = Error::NO_ERROR;
-        if (waitLoopsWhilePinIs(ONEWIRE_TIME_RESET_MIN[od_mode] - ONEWIRE_TIME_SLOT_MAX[od_mode] - ONEWIRE_TIME_READ_MAX[od_mode], false) == 0) // last number should read: max(ONEWIRE_TIME_WRITE_ZERO,ONEWIRE_TIME_READ_MAX)
+        maskSlot();
+        if (waitLoopsWhilePinIs(ONEWIRE_TIME_RESET_MIN[od_mode] - timing.slot_max[od_mode] - ONEWIRE_TIME_READ_MAX[od_mode], false) == 0) // last number should read: max(ONEWIRE_TIME_WRITE_ZERO,ONEWIRE_TIME_READ_MAX)
         {
 #if OVERDRIVE_ENABLE
+            // the low state already lasted for the wait above, a normal reset needs RESET_MIN[0] in total
             const timeOW_t loops_remaining = waitLoopsWhilePinIs(ONEWIRE_TIME_RESET_MAX[0], false); // showPresence() wants to start at high, so wait for it
-            if (od_mode && ((ONEWIRE_TIME_RESET_MAX[0] - ONEWIRE_TIME_RESET_MIN[od_mode]) > loops_remaining))
+            const timeOW_t loops_waited    = ONEWIRE_TIME_RESET_MIN[od_mode] - timing.slot_max[od_mode] - ONEWIRE_TIME_READ_MAX[od_mode];
+            if (od_mode && ((ONEWIRE_TIME_RESET_MAX[0] - loops_remaining + loops_waited) > ONEWIRE_TIME_RESET_MIN[0]))
             {
                 od_mode = false; // normal reset detected, so leave OD-Mode
             };
 #else
             waitLoopsWhilePinIs(ONEWIRE_TIME_RESET_MAX[0], false); // showPresence() wants to start at high, so wait for it
 #endif
+            unmaskSlot();
             return false;
         }
+        unmaskSlot();
     }
 
-    if (!DIRECT_READ(pin_baseReg, pin_bitMask))
+    if (!DIRECT_READ(pinBaseReg(), pin_bitMask))
         return true; // just leave if pin is Low, don't bother to wait, TODO: really needed?
 
     // wait for the bus to become low (master-controlled), since we are polling we don't know for how long it was zero
-    if (waitLoopsWhilePinIs(ONEWIRE_TIME_RESET_TIMEOUT, true) == 0)
+    if (waitLoopsWhilePinIs(timeout, true) == 0)
     {
         //_error = Error::WAIT_RESET_TIMEOUT;
+        bus_idle = (idle_before < ONEWIRE_TIME_RESET_TIMEOUT) ? (idle_before + timeout) : idle_before;
         return true;
     }
 
+    return checkResetLow();
+}
+
+// the bus is low already, measure how long it stays there. loops_passed: the low state started that long before (wake-up of the mcu)
+ONEWIRE_HOT bool OneWireHub::checkResetLow(const timeOW_t loops_passed)
+{
+    maskSlot(); // the presence follows the release of the bus, an ISR must not delay seeing it
     const timeOW_t loops_remaining = waitLoopsWhilePinIs(ONEWIRE_TIME_RESET_MAX[0], false);
+    unmaskSlot();
+    const bool     is_reset        = (loops_remaining <= (ONEWIRE_TIME_RESET_MAX[0] - ONEWIRE_TIME_RESET_MIN[od_mode] + loops_passed));
 
     // wait for bus-release by master
     if (loops_remaining == 0)
@@ -316,61 +1089,98 @@ bool OneWireHub::checkReset(void) // there is a specific high-time needed before
     }
 
 #if OVERDRIVE_ENABLE
-    if (od_mode && ((ONEWIRE_TIME_RESET_MAX[0] - ONEWIRE_TIME_RESET_MIN[0]) > loops_remaining))
+    if (od_mode && ((ONEWIRE_TIME_RESET_MAX[0] - ONEWIRE_TIME_RESET_MIN[0] + loops_passed) > loops_remaining))
     {
         od_mode = false; // normal reset detected, so leave OD-Mode
     };
 #endif
 
+    trace(TraceEvent::RESET, is_reset ? 1 : 0, loops_remaining);
+
+    if (is_reset)
+        recordReset();
+
+#if USE_ADAPTIVE_TIMING
+    if (is_reset)
+    {
+        const timeOW_t reset_length = ONEWIRE_TIME_RESET_MAX[0] - loops_remaining + loops_passed;
+        if ((timing.reset_min == 0) || (reset_length < timing.reset_min))
+            timing.reset_min = reset_length;
+        if (reset_length > timing.reset_max)
+            timing.reset_max = reset_length;
+    }
+    else if (timing_check)
+    {
+        resetTimingProfile(); // the master went on with timeslots, the transaction was cut short by the tight timeout
+    }
+    timing_check = false;
+#endif
+
     // If the master pulled low for to short this will trigger an error
     //if (loops_remaining > (ONEWIRE_TIME_RESET_MAX[0] - ONEWIRE_TIME_RESET_MIN[od_mode])) _error = Error::VERY_SHORT_RESET; // could be activated again, like the error above, errorhandling is mature enough now
 
-    return (loops_remaining > (ONEWIRE_TIME_RESET_MAX[0] - ONEWIRE_TIME_RESET_MIN[od_mode]));
+    return !is_reset;
 }
 
-bool OneWireHub::showPresence(void)
+ONEWIRE_HOT bool OneWireHub::showPresence(void)
 {
     static_assert(ONEWIRE_TIME_PRESENCE_MAX[0] > ONEWIRE_TIME_PRESENCE_MIN[0], "Timings are wrong");
 #if OVERDRIVE_ENABLE
     static_assert(ONEWIRE_TIME_PRESENCE_MAX[1] > ONEWIRE_TIME_PRESENCE_MIN[1], "Timings are wrong");
 #endif
 
+    maskSlot();
+    const bool stuck_low = pulsePresence();
+    unmaskSlot();
+    if (stuck_low)
+    {
+        _error = Error::PRESENCE_LOW_ON_LINE;
+        return true;
+    }
+
+    return false;
+}
+
+// pulls the presence after a reset, returns true if the bus stayed low. leaves _error alone, so the ISR can use it
+ONEWIRE_HOT bool OneWireHub::pulsePresence(void)
+{
     // Master will delay it's "Presence" check (bus-read)  after the reset
     waitLoopsWhilePinIs(ONEWIRE_TIME_PRESENCE_TIMEOUT, true); // no pinCheck demanded, but this additional check can cut waitTime
 
-    if (USE_GPIO_DEBUG)
+    if (useGpioDebug())
         DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
 
     // pull the bus low and hold it some time
-    DIRECT_WRITE_LOW(pin_baseReg, pin_bitMask);
-    DIRECT_MODE_OUTPUT(pin_baseReg, pin_bitMask); // drive output low
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
+    DIRECT_MODE_OUTPUT(pinBaseReg(), pin_bitMask); // drive output low
 
     wait(ONEWIRE_TIME_PRESENCE_MIN[od_mode]); // stays till the end, because it drives the bus low itself
 
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask); // allow it to float
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask); // allow it to float
 
-    if (USE_GPIO_DEBUG)
+    if (useGpioDebug())
         DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
 
-    // When the master or other slaves release the bus within a given time everything is fine
-    if (waitLoopsWhilePinIs((ONEWIRE_TIME_PRESENCE_MAX[od_mode] - ONEWIRE_TIME_PRESENCE_MIN[od_mode]), false) == 0)
-    {
-        _error = Error::PRESENCE_LOW_ON_LINE;
-        return true;
-    }
-
-    return false;
+    // When the master or other slaves release the bus within a given time everything is fine
+    const timeOW_t loops_remaining = waitLoopsWhilePinIs((ONEWIRE_TIME_PRESENCE_MAX[od_mode] - ONEWIRE_TIME_PRESENCE_MIN[od_mode]), false);
+    trace(TraceEvent::PRESENCE, (loops_remaining == 0) ? 1 : 0, loops_remaining);
+    return (loops_remaining == 0);
 }
 
 // note: this FN calls sendBit() & recvBit() but doesn't handle interrupts -> calling FN must do this
-void OneWireHub::searchIDTree(void)
+ONEWIRE_HOT void OneWireHub::searchIDTree(const IDTree &tree)
 {
-    uint8_t position_IDBit = 0;
-    uint8_t trigger_pos = 0;
-    uint8_t active_slave = idTree[trigger_pos].slave_selected;
-    uint8_t trigger_bit = idTree[trigger_pos].id_position;
+    if (tree.root == ID_TREE_NONE)
+        return;
 
-    noInterrupts();
+    constexpr uint8_t stream_shift { 8 / SEARCH_BITS_PER_BYTE };
+
+    uint8_t position_IDBit = 0;
+    tree_t  trigger_pos = tree.root;
+    uint8_t active_slave = tree.element[trigger_pos].slave_selected;
+    uint8_t trigger_bit = tree.element[trigger_pos].id_position;
+    const uint8_t *stream = getSearchStream(active_slave);
+    uint8_t stream_bits = stream[0];
 
     while (position_IDBit < 64)
     {
@@ -387,34 +1197,29 @@ void OneWireHub::searchIDTree(void)
                 return;
 
             // switch to next junction
-            trigger_pos = bit_recv ? idTree[trigger_pos].got_one : idTree[trigger_pos].got_zero;
+            trigger_pos = bit_recv ? tree.element[trigger_pos].got_one : tree.element[trigger_pos].got_zero;
 
-            active_slave = idTree[trigger_pos].slave_selected;
+            active_slave = tree.element[trigger_pos].slave_selected;
 
-            trigger_bit = (trigger_pos == 255) ? uint8_t(255) : idTree[trigger_pos].id_position;
+            trigger_bit = tree.element[trigger_pos].id_position;
+
+            // continue with the stream of the new slave, it is in sync after the shift below
+            stream = getSearchStream(active_slave);
+            stream_bits = static_cast<uint8_t>(stream[position_IDBit / SEARCH_BITS_PER_BYTE] >> ((position_IDBit % SEARCH_BITS_PER_BYTE) * stream_shift));
         }
         else
         {
-            const uint8_t pos_byte = (position_IDBit >> 3);
-            const uint8_t mask_bit = (static_cast<uint8_t>(1) << (position_IDBit & (7)));
-            bool bit_send;
+            const bool bit_send = (stream_bits & 0b01) != 0;
+#if USE_SEARCH_STREAM
+            const bool bit_cmpl = (stream_bits & 0b10) != 0;
+#else
+            const bool bit_cmpl = !bit_send;
+#endif
 
-            if ((slave_list[active_slave]->ID[pos_byte] & mask_bit) != 0)
-            {
-                bit_send = true;
-                if (sendBit(true))
-                    return;
-                if (sendBit(false))
-                    return;
-            }
-            else
-            {
-                bit_send = false;
-                if (sendBit(false))
-                    return;
-                if (sendBit(true))
-                    return;
-            }
+            if (sendBit(bit_send))
+                return;
+            if (sendBit(bit_cmpl))
+                return;
 
             const bool bit_recv = recvBit();
             if (_error != Error::NO_ERROR)
@@ -424,37 +1229,208 @@ void OneWireHub::searchIDTree(void)
                 return;
         }
         position_IDBit++;
-    }
 
-    interrupts();
+        stream_bits >>= stream_shift;
+        if (((position_IDBit % SEARCH_BITS_PER_BYTE) == 0) && (position_IDBit < 64))
+            stream_bits = stream[position_IDBit / SEARCH_BITS_PER_BYTE];
+    }
 
-    slave_selected = slave_list[active_slave];
+    slave_selected        = slave_list[active_slave];
+    slave_selected_number = active_slave;
 }
 
-bool OneWireHub::recvAndProcessCmd(void)
+ONEWIRE_HOT bool OneWireHub::recvAndProcessCmd(void)
 {
-    uint8_t address[8], cmd;
-    bool flag = false;
+    uint8_t cmd;
 
     recv(&cmd);
 
+    bool failed;
     if (_error == Error::RESET_IN_PROGRESS)
-        return false; // stay in poll()-loop and trigger another datastream-detection
-    if (_error != Error::NO_ERROR)
-        return true;
+        failed = false; // stay in poll()-loop and trigger another datastream-detection
+    else if (_error != Error::NO_ERROR)
+        failed = true;
+    else
+        failed = processCmd(cmd);
+
+    adaptTiming();
+    return failed;
+}
+
+ONEWIRE_HOT void OneWireHub::adaptTiming(void)
+{
+#if USE_ADAPTIVE_TIMING
+    switch (_error)
+    {
+        case Error::NO_ERROR:
+        case Error::RESET_IN_PROGRESS:
+            break;
+
+        case Error::FIRST_BIT_OF_BYTE_TIMEOUT:
+            // regular end if the master is done, checkResetLow() sees if it was not
+            timing_check = timing.adapted;
+            break;
+
+        default:
+            if (timing.adapted)
+                resetTimingProfile();
+            else
+                timing.transactions = 0;
+            return;
+    }
+
+    if (timing.adapted || od_mode || (++timing.transactions < TIMING_LEARN_TRANSACTIONS))
+        return;
+
+    // twice the longest low state and four times the longest gap, bounded by the datasheet-values and the config
+    const timeOW_t slot_max = timing.slot_low_max << 1;
+    const timeOW_t msg_high = timing.slot_high_max << 2;
+    timing.slot_max[0] = (slot_max < ONEWIRE_TIME_READ_MAX[0]) ? ONEWIRE_TIME_READ_MAX[0] : ((slot_max > ONEWIRE_TIME_SLOT_MAX[0]) ? ONEWIRE_TIME_SLOT_MAX[0] : slot_max);
+    timing.msg_high_timeout = (msg_high < ONEWIRE_TIME_RESET_MAX[0]) ? ONEWIRE_TIME_RESET_MAX[0] : ((msg_high > ONEWIRE_TIME_MSG_HIGH_TIMEOUT) ? ONEWIRE_TIME_MSG_HIGH_TIMEOUT : msg_high);
+    timing.adapted = true;
+#endif
+}
+
+// runs between reset and presence, so only the timestamps are taken here
+ONEWIRE_HOT void OneWireHub::recordReset(void)
+{
+    const uint32_t time_now = micros();
+    const bool     new_burst = (time_now - period_last_reset) >= RESET_BURST_GAP_US;
+    period_last_reset = time_now;
+    if (!new_burst)
+        return;
+
+    if (period_burst_start != 0)
+    {
+        period_sample  = time_now - period_burst_start;
+        period_pending = true;
+    }
+    period_burst_start = time_now;
+}
+
+void OneWireHub::updatePeriod(void)
+{
+    noInterrupts();
+    const bool     pending = period_pending;
+    const uint32_t sample  = period_sample;
+    period_pending = false;
+    interrupts();
+
+    if (!pending)
+        return;
+
+    // a skipped poll of the master only adds jitter, but a new period takes over after a few samples
+    if ((period_samples != 0) && ((sample > (period_average + (period_average >> 1))) || (sample < (period_average >> 1))))
+    {
+        if (++period_outliers < 3)
+        {
+            period_jitter = period_jitter - (period_jitter >> 3) + (period_average >> 3);
+            return;
+        }
+        period_samples = 0;
+    }
+    period_outliers = 0;
+
+    if (period_samples == 0)
+    {
+        period_average = sample;
+        period_jitter  = 0;
+    }
+    else
+    {
+        const uint32_t deviation = (sample > period_average) ? (sample - period_average) : (period_average - sample);
+        period_average = period_average - (period_average >> 3) + (sample >> 3);
+        period_jitter  = period_jitter - (period_jitter >> 3) + (deviation >> 3);
+    }
+
+    if (period_samples < 255)
+        period_samples++;
+}
+
+uint32_t OneWireHub::timeUntilNextExpectedReset(uint8_t &confidence)
+{
+    updatePeriod();
+
+    confidence = 0;
+    if ((period_samples == 0) || (period_average == 0))
+        return 0;
+
+    // four times the jitter as a share of the period, in 1/256
+    const uint32_t spread = (period_jitter << 2) / ((period_average >> 8) + 1);
+    uint32_t trust = (spread >= 255) ? 0 : (255 - spread);
+    if (period_samples < PERIOD_LEARN_SAMPLES)
+        trust = (trust * period_samples) / PERIOD_LEARN_SAMPLES;
+    confidence = static_cast<uint8_t>(trust);
+
+    const uint32_t time_now = micros();
+    if ((time_now - period_last_reset) < RESET_BURST_GAP_US)
+        return 0; // the master is busy right now
+
+    // the next poll is expected some jitter earlier, a late one is expected any moment
+    const uint32_t guard   = period_jitter << 1;
+    const uint32_t elapsed = time_now - period_burst_start;
+    const uint32_t phase   = elapsed % period_average;
+    if ((elapsed >= period_average) && (phase < guard))
+        return 0;
+
+    const uint32_t remaining = period_average - phase;
+    return (remaining > guard) ? (remaining - guard) : 0;
+}
+
+uint32_t OneWireHub::getMasterPeriod(void) const
+{
+    return period_average;
+}
+
+void OneWireHub::getTimingProfile(OneWireTimingProfile &profile) const
+{
+    noInterrupts();
+    profile = timing;
+    interrupts();
+}
+
+void OneWireHub::resetTimingProfile(void)
+{
+    timing.slot_max[0]      = ONEWIRE_TIME_SLOT_MAX[0];
+    timing.slot_max[1]      = ONEWIRE_TIME_SLOT_MAX[1];
+    timing.msg_high_timeout = ONEWIRE_TIME_MSG_HIGH_TIMEOUT;
+    timing.reset_min        = 0;
+    timing.reset_max        = 0;
+    timing.slot_low_max     = 0;
+    timing.slot_high_max    = 0;
+    timing.transactions     = 0;
+    timing.adapted          = false;
+    timing_check            = false;
+}
+
+// handles everything after the rom-command was received, shared by poll() and the interrupt-engine
+ONEWIRE_HOT bool OneWireHub::processCmd(const uint8_t cmd)
+{
+    mask_t candidates;
+#if OVERDRIVE_ENABLE
+    bool   od_match = false;
+#endif
+
+    recordRomCmd(cmd);
 
     switch (cmd)
     {
     case 0xF0: // Search rom
 
         slave_selected = nullptr;
-        searchIDTree();
+        maskInterrupts();
+        searchIDTree(getIDTree(false));
+        unmaskInterrupts();
         return false; // always trigger a re-init after searchIDTree
 
     case 0x69: // overdrive MATCH ROM
 
 #if OVERDRIVE_ENABLE
-        od_mode = true;
+        // only the overdrive-slaves switch speed and receive the address, the others wait for the next normal reset
+        if (maskIsEmpty(od_mask))
+            return true;
+        od_mode  = true;
+        od_match = true;
         waitLoopsWhilePinIs(ONEWIRE_TIME_READ_MAX[0], false);
 #endif
 
@@ -462,49 +1438,53 @@ bool OneWireHub::recvAndProcessCmd(void)
 
         slave_selected = nullptr;
 
-        if (recv(address, 8))
-        {
-            break;
-        }
-
-        for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
+        // narrow the candidates with every received byte, the decision is ready with the last bit
+        candidates = getSpeedMask();
+        for (uint8_t j = 0; j < 8; ++j)
         {
-            if (slave_list[i] == nullptr)
-                continue;
+            uint8_t address;
+            if (recv(&address))
+                break;
 
-            flag = true;
-            for (uint8_t j = 0; j < 8; ++j)
+            for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
             {
-                if (slave_list[i]->ID[j] != address[j])
-                {
-                    flag = false;
-                    break;
-                }
+                if (maskTest(candidates, i) && (slave_list[i]->ID[j] != address))
+                    maskReset(candidates, i);
             }
 
-            if (flag)
+            if (maskIsEmpty(candidates))
             {
-                slave_selected = slave_list[i];
-                break;
+#if OVERDRIVE_ENABLE
+                if (od_match)
+                    od_mode = false; // not addressed by overdrive MATCH ROM, fall back to normal speed
+#endif
+                return true; // no slave of this hub is addressed, ignore the rest and wait for the next reset
             }
         }
 
-        if (!flag)
+        if (_error != Error::NO_ERROR)
+            break;
+
+        for (uint8_t i = 0; i < ONEWIRESLAVE_LIMIT; ++i)
         {
-            return true;
+            if (maskTest(candidates, i))
+            {
+                slave_selected        = slave_list[i];
+                slave_selected_number = i;
+                break;
+            }
         }
 
         if (slave_selected != nullptr)
-        {
-            if (USE_GPIO_DEBUG)
-                DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
-            slave_selected->duty(this);
-        }
+            dutySelected();
         break;
 
     case 0x3C: // overdrive SKIP ROM
 
 #if OVERDRIVE_ENABLE
+        // all overdrive-slaves switch speed, the others wait for the next normal reset
+        if (maskIsEmpty(od_mask))
+            return true;
         od_mode = true;
         waitLoopsWhilePinIs(ONEWIRE_TIME_READ_MAX[0], false);
 #endif
@@ -513,16 +1493,13 @@ bool OneWireHub::recvAndProcessCmd(void)
         // NOTE: If more than one slave is present on the bus,
         // and a read command is issued following the Skip ROM command,
         // data collision will occur on the bus as multiple slaves transmit simultaneously
-        if ((slave_selected == nullptr) && (slave_count == 1))
+        if ((slave_selected == nullptr) && (slave_count == 1) && maskTest(getSpeedMask(), getIndexOfNextSensorInList()))
         {
-            slave_selected = slave_list[getIndexOfNextSensorInList()];
+            slave_selected_number = getIndexOfNextSensorInList();
+            slave_selected        = slave_list[slave_selected_number];
         }
         if (slave_selected != nullptr)
-        {
-            if (USE_GPIO_DEBUG)
-                DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
-            slave_selected->duty(this);
-        }
+            dutySelected();
         break;
 
     case 0x0F: // OLD READ ROM
@@ -532,9 +1509,10 @@ bool OneWireHub::recvAndProcessCmd(void)
     case 0x33: // READ ROM
 
         // only usable when there is ONE slave on the bus
-        if ((slave_selected == nullptr) && (slave_count == 1))
+        if ((slave_selected == nullptr) && (slave_count == 1) && maskTest(getSpeedMask(), getIndexOfNextSensorInList()))
         {
-            slave_selected = slave_list[getIndexOfNextSensorInList()];
+            slave_selected_number = getIndexOfNextSensorInList();
+            slave_selected        = slave_list[slave_selected_number];
         }
         if (slave_selected != nullptr)
         {
@@ -542,19 +1520,22 @@ bool OneWireHub::recvAndProcessCmd(void)
         }
         return false;
 
+#if USE_ALARM_SEARCH
     case 0xEC: // ALARM SEARCH
 
-        // TODO: Alarm searchIDTree command, respond if flag is set
         // is like searchIDTree-rom, but only slaves with triggered alarm will appear
-        break;
+        slave_selected = nullptr;
+        maskInterrupts();
+        searchIDTree(getIDTree(true));
+        unmaskInterrupts();
+        return false; // always trigger a re-init after searchIDTree
 
+#endif
     case 0xA5: // RESUME COMMAND
 
         if (slave_selected == nullptr)
             return true;
-        if (USE_GPIO_DEBUG)
-            DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
-        slave_selected->duty(this);
+        dutySelected();
         break;
 
     default: // Unknown command
@@ -569,56 +1550,125 @@ bool OneWireHub::recvAndProcessCmd(void)
     return (_error != Error::NO_ERROR);
 }
 
+ONEWIRE_HOT void OneWireHub::dutySelected(void)
+{
+    if (useGpioDebug())
+        DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
+    duty_cmd_pending = true;
+    trace(TraceEvent::DUTY_START, slave_selected->ID[0], 0);
+    slave_selected->duty(this);
+    trace(TraceEvent::DUTY_END, static_cast<uint8_t>(_error), 0);
+    duty_cmd_pending = false;
+    if (slave_selected->hasActivity())
+        activity_pending = true;
+}
+
+ONEWIRE_HOT void OneWireHub::maskInterrupts(void)
+{
+    if (isrActive() || (mask_scope != MaskScope::CALL))
+        return;
+    if (mask_depth++ == 0)
+        ONEWIRE_INTERRUPTS_OFF();
+}
+
+ONEWIRE_HOT void OneWireHub::unmaskInterrupts(void)
+{
+    if (isrActive() || (mask_scope != MaskScope::CALL) || (mask_depth == 0))
+        return;
+    if (--mask_depth == 0)
+        ONEWIRE_INTERRUPTS_ON();
+}
+
+ONEWIRE_HOT void OneWireHub::maskSlot(void)
+{
+    if (mask_scope == MaskScope::SLOT)
+        ONEWIRE_INTERRUPTS_OFF();
+}
+
+ONEWIRE_HOT void OneWireHub::unmaskSlot(void)
+{
+    if (mask_scope == MaskScope::SLOT)
+        ONEWIRE_INTERRUPTS_ON();
+}
+
+void OneWireHub::setMaskScope(const MaskScope scope)
+{
+    if (mask_depth != 0)
+        return; // inside a critical section
+    mask_scope = scope;
+}
+
+uint8_t OneWireHub::getPinNumber(void) const
+{
+    return pin_number;
+}
+
 // info: check for errors after calling and break/return if possible, returns true if error is detected
-// NOTE: if called separately you need to handle interrupts, should be disabled during this FN
-bool OneWireHub::sendBit(const bool value)
+// NOTE: if called separately you need to handle interrupts (maskInterrupts()), should be masked during this FN
+ONEWIRE_HOT bool OneWireHub::sendBit(const bool value)
 {
+#if USE_INTERRUPT_ENGINE
+    if (isrActive())
+        return isrSendBit(value);
+#endif
+
     const bool writeZero = !value;
 
+    maskSlot();
+
     // Wait for bus to rise HIGH, signaling end of last timeslot
-    timeOW_t retries = ONEWIRE_TIME_SLOT_MAX[od_mode];
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) == 0) && (--retries != 0))
-        ;
-    if (retries == 0)
+    const timeOW_t loops_slot = waitLoopsWhilePinIs(timing.slot_max[od_mode], false);
+    if (loops_slot == 0)
     {
+        unmaskSlot();
         _error = Error::RESET_IN_PROGRESS;
         return true;
     }
+    unmaskSlot(); // the master may pause up to msg_high_timeout between two slots, other ISRs run meanwhile
 
     // Wait for bus to fall LOW, start of new timeslot
-    retries = ONEWIRE_TIME_MSG_HIGH_TIMEOUT;
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) != 0) && (--retries != 0))
-        ;
-    if (retries == 0)
+    const timeOW_t loops_high = waitLoopsWhilePinIs(timing.msg_high_timeout, true);
+    if (loops_high == 0)
     {
         _error = Error::AWAIT_TIMESLOT_TIMEOUT_HIGH;
         return true;
     }
+    maskSlot(); // from the falling edge until the bus is released / sampled
+
+#if USE_ADAPTIVE_TIMING
+    if (!od_mode)
+    {
+        if ((timing.slot_max[0] - loops_slot) > timing.slot_low_max)
+            timing.slot_low_max = timing.slot_max[0] - loops_slot;
+        if ((timing.msg_high_timeout - loops_high) > timing.slot_high_max)
+            timing.slot_high_max = timing.msg_high_timeout - loops_high;
+    }
+#endif
 
     // first difference to inner-loop of read()
     if (writeZero)
     {
-        DIRECT_MODE_OUTPUT(pin_baseReg, pin_bitMask);
-        retries = ONEWIRE_TIME_WRITE_ZERO[od_mode];
+        DIRECT_MODE_OUTPUT(pinBaseReg(), pin_bitMask);
+        waitLoopsWhilePinIs(ONEWIRE_TIME_WRITE_ZERO[od_mode], false);
     }
     else
     {
-        retries = ONEWIRE_TIME_READ_MAX[od_mode];
+        waitLoopsWhilePinIs(ONEWIRE_TIME_READ_MAX[od_mode], false); // TODO: we should check for a timeout because there could be a reset in progress...
     }
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
+    unmaskSlot();
 
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) == 0) && (--retries != 0))
-        ; // TODO: we should check for (!retries) because there could be a reset in progress...
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    trace(TraceEvent::SEND_BIT, value ? 1 : 0, loops_slot); // the bus is released already
 
     return false;
 }
 
 // should be the prefered function for writes, returns true if error occured
-bool OneWireHub::send(const uint8_t address[], const uint8_t data_length)
+ONEWIRE_HOT bool OneWireHub::send(const uint8_t address[], const uint8_t data_length)
 {
-    noInterrupts(); // will be enabled at the end of function
-    DIRECT_WRITE_LOW(pin_baseReg, pin_bitMask);
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    maskInterrupts(); // will be unmasked at the end of function
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
     uint8_t bytes_sent = 0;
 
     for (; bytes_sent < data_length; ++bytes_sent) // loop for sending bytes
@@ -631,25 +1681,25 @@ bool OneWireHub::send(const uint8_t address[], const uint8_t data_length)
             {
                 if ((bitMask == 0x01) && (_error == Error::AWAIT_TIMESLOT_TIMEOUT_HIGH))
                     _error = Error::FIRST_BIT_OF_BYTE_TIMEOUT;
-                interrupts();
+                unmaskInterrupts();
                 return true;
             }
         }
-        if (USE_GPIO_DEBUG)
+        if (useGpioDebug())
         {
             DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
             DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
         }
     }
-    interrupts();
+    unmaskInterrupts();
     return (bytes_sent != data_length);
 }
 
-bool OneWireHub::send(const uint8_t address[], const uint8_t data_length, uint16_t &crc16)
+ONEWIRE_HOT bool OneWireHub::send(const uint8_t address[], const uint8_t data_length, uint16_t &crc16)
 {
-    noInterrupts(); // will be enabled at the end of function
-    DIRECT_WRITE_LOW(pin_baseReg, pin_bitMask);
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    maskInterrupts(); // will be unmasked at the end of function
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
     uint8_t bytes_sent = 0;
 
     for (; bytes_sent < data_length; ++bytes_sent) // loop for sending bytes
@@ -662,67 +1712,88 @@ bool OneWireHub::send(const uint8_t address[], const uint8_t data_length, uint16
             {
                 if ((counter == 0) && (_error == Error::AWAIT_TIMESLOT_TIMEOUT_HIGH))
                     _error = Error::FIRST_BIT_OF_BYTE_TIMEOUT;
-                interrupts();
+                unmaskInterrupts();
                 return true;
             }
 
+#if (USE_CRC16_TABLE == 0)
             const uint8_t mix = ((uint8_t)crc16 ^ dataByte) & static_cast<uint8_t>(0x01);
             crc16 >>= 1;
             if (mix != 0)
                 crc16 ^= static_cast<uint16_t>(0xA001);
+#endif
             dataByte >>= 1;
         }
-        if (USE_GPIO_DEBUG)
+
+#if (USE_CRC16_TABLE != 0)
+        crc16 = crc16Update(crc16, address[bytes_sent]); // the master is still busy with the last timeslot
+#endif
+        if (useGpioDebug())
         {
             DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
             DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
         }
     }
-    interrupts();
+    unmaskInterrupts();
     return (bytes_sent != data_length);
 }
 
-bool OneWireHub::send(const uint8_t dataByte)
+ONEWIRE_HOT bool OneWireHub::send(const uint8_t dataByte)
 {
     return send(&dataByte, 1);
 }
 
-// NOTE: if called separately you need to handle interrupts, should be disabled during this FN
-bool OneWireHub::recvBit(void)
+// NOTE: if called separately you need to handle interrupts (maskInterrupts()), should be masked during this FN
+ONEWIRE_HOT bool OneWireHub::recvBit(void)
 {
+#if USE_INTERRUPT_ENGINE
+    if (isrActive())
+        return isrRecvBit();
+#endif
+
+    maskSlot();
+
     // Wait for bus to rise HIGH, signaling end of last timeslot
-    timeOW_t retries = ONEWIRE_TIME_SLOT_MAX[od_mode];
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) == 0) && (--retries != 0))
-        ;
-    if (retries == 0)
+    const timeOW_t loops_slot = waitLoopsWhilePinIs(timing.slot_max[od_mode], false);
+    if (loops_slot == 0)
     {
+        unmaskSlot();
         _error = Error::RESET_IN_PROGRESS;
         return true;
     }
+    unmaskSlot(); // the master may pause up to msg_high_timeout between two slots, other ISRs run meanwhile
 
     // Wait for bus to fall LOW, start of new timeslot
-    retries = ONEWIRE_TIME_MSG_HIGH_TIMEOUT;
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) != 0) && (--retries != 0))
-        ;
-    if (retries == 0)
+    const timeOW_t loops_high = waitLoopsWhilePinIs(timing.msg_high_timeout, true);
+    if (loops_high == 0)
     {
         _error = Error::AWAIT_TIMESLOT_TIMEOUT_HIGH;
         return true;
     }
+    maskSlot(); // from the falling edge until the bus is released / sampled
 
-    // wait a specific time to do a read (data is valid by then), // first difference to inner-loop of write()
-    retries = ONEWIRE_TIME_READ_MIN[od_mode];
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) == 0) && (--retries != 0))
-        ;
+#if USE_ADAPTIVE_TIMING
+    if (!od_mode)
+    {
+        if ((timing.slot_max[0] - loops_slot) > timing.slot_low_max)
+            timing.slot_low_max = timing.slot_max[0] - loops_slot;
+        if ((timing.msg_high_timeout - loops_high) > timing.slot_high_max)
+            timing.slot_high_max = timing.msg_high_timeout - loops_high;
+    }
+#endif
 
-    return (retries > 0);
+    // wait a specific time to do a read (data is valid by then), // first difference to inner-loop of write()
+    const bool value = (waitLoopsWhilePinIs(ONEWIRE_TIME_READ_MIN[od_mode], false) > 0);
+    unmaskSlot();
+    trace(TraceEvent::RECV_BIT, value ? 1 : 0, loops_slot);
+    return value;
 }
 
-bool OneWireHub::recv(uint8_t address[], const uint8_t data_length)
+ONEWIRE_HOT bool OneWireHub::recv(uint8_t address[], const uint8_t data_length)
 {
-    noInterrupts(); // will be enabled at the end of function
-    DIRECT_WRITE_LOW(pin_baseReg, pin_bitMask);
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    maskInterrupts(); // will be unmasked at the end of function
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
 
     uint8_t bytes_received = 0;
     for (; bytes_received < data_length; ++bytes_received)
@@ -737,73 +1808,75 @@ bool OneWireHub::recv(uint8_t address[], const uint8_t data_length)
             {
                 if ((bitMask == 0x01) && (_error == Error::AWAIT_TIMESLOT_TIMEOUT_HIGH))
                     _error = Error::FIRST_BIT_OF_BYTE_TIMEOUT;
-                interrupts();
+                unmaskInterrupts();
                 return true;
             }
         }
 
         address[bytes_received] = value;
+        recordDutyCmd(value);
 
-        if (USE_GPIO_DEBUG)
+        if (useGpioDebug())
         {
             DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
             DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
         }
     }
 
-    interrupts();
+    unmaskInterrupts();
     return (bytes_received != data_length);
 }
 
 // should be the prefered function for reads, returns true if error occured
-bool OneWireHub::recv(uint8_t address[], const uint8_t data_length, uint16_t &crc16)
+ONEWIRE_HOT bool OneWireHub::recv(uint8_t address[], const uint8_t data_length, uint16_t &crc16)
 {
-    noInterrupts(); // will be enabled at the end of function
-    DIRECT_WRITE_LOW(pin_baseReg, pin_bitMask);
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    maskInterrupts(); // will be unmasked at the end of function
+    DIRECT_WRITE_LOW(pinBaseReg(), pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
 
     uint8_t bytes_received = 0;
     for (; bytes_received < data_length; ++bytes_received)
     {
         uint8_t value = 0;
-        uint8_t mix = 0;
         for (uint8_t bitMask = 0x01; bitMask != 0; bitMask <<= 1)
         {
-            if (recvBit())
-            {
+            const uint8_t bit_recv = recvBit() ? uint8_t(1) : uint8_t(0);
+            if (bit_recv != 0)
                 value |= bitMask;
-                mix = 1;
-            }
-            else
-                mix = 0;
 
             if (_error != Error::NO_ERROR)
             {
                 if ((bitMask == 0x01) && (_error == Error::AWAIT_TIMESLOT_TIMEOUT_HIGH))
                     _error = Error::FIRST_BIT_OF_BYTE_TIMEOUT;
-                interrupts();
+                unmaskInterrupts();
                 return true;
             }
 
-            mix ^= static_cast<uint8_t>(crc16) & static_cast<uint8_t>(0x01);
+#if (USE_CRC16_TABLE == 0)
+            const uint8_t mix = bit_recv ^ (static_cast<uint8_t>(crc16) & static_cast<uint8_t>(0x01));
             crc16 >>= 1;
             if (mix != 0)
                 crc16 ^= static_cast<uint16_t>(0xA001);
+#endif
         }
 
+#if (USE_CRC16_TABLE != 0)
+        crc16 = crc16Update(crc16, value); // the master is still busy with the last timeslot
+#endif
         address[bytes_received] = value;
-        if (USE_GPIO_DEBUG)
+        recordDutyCmd(value);
+        if (useGpioDebug())
         {
             DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
             DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
         }
     }
 
-    interrupts();
+    unmaskInterrupts();
     return (bytes_received != data_length);
 }
 
-void OneWireHub::wait(const uint16_t timeout_us) const
+ONEWIRE_HOT void OneWireHub::wait(const uint16_t timeout_us) const
 {
     timeOW_t loops = timeUsToLoops(timeout_us);
     bool state = false;
@@ -814,7 +1887,7 @@ void OneWireHub::wait(const uint16_t timeout_us) const
     }
 }
 
-void OneWireHub::wait(const timeOW_t loops_wait) const
+ONEWIRE_HOT void OneWireHub::wait(const timeOW_t loops_wait) const
 {
     timeOW_t loops = loops_wait;
     bool state = false;
@@ -826,13 +1899,26 @@ void OneWireHub::wait(const timeOW_t loops_wait) const
 }
 
 // returns false if pins stays in the wanted state all the time
-timeOW_t OneWireHub::waitLoopsWhilePinIs(volatile timeOW_t retries, const bool pin_value) const
+ONEWIRE_HOT timeOW_t OneWireHub::waitLoopsWhilePinIs(volatile timeOW_t retries, const bool pin_value) const
 {
     if (retries == 0)
         return 0;
-    while ((DIRECT_READ(pin_baseReg, pin_bitMask) == pin_value) && (--retries != 0))
+#if HUB_CYCLE_TIMING
+    // retries is a timespan in cpu-cycles, the returned remainder as well
+    const timeOW_t time_start = ONEWIRE_CYCLE_COUNT();
+    timeOW_t time_elapsed = 0;
+    while (DIRECT_READ(pinBaseReg(), pin_bitMask) == pin_value)
+    {
+        time_elapsed = ONEWIRE_CYCLE_COUNT() - time_start;
+        if (time_elapsed >= retries)
+            return 0;
+    }
+    return (retries - time_elapsed);
+#else
+    while ((DIRECT_READ(pinBaseReg(), pin_bitMask) == pin_value) && (--retries != 0))
         ;
     return retries;
+#endif
 }
 
 void OneWireHub::waitLoops1ms(void)
@@ -844,7 +1930,7 @@ void OneWireHub::waitLoops1ms(void)
         while (loops_left != 0)
         {
             waitLoopsWhilePinIs(loops_1ms, false);
-            DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+            DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
             DIRECT_WRITE_HIGH(debug_baseReg, debug_bitMask);
             loops_left = waitLoopsWhilePinIs(loops_1ms, true);
             DIRECT_WRITE_LOW(debug_baseReg, debug_bitMask);
@@ -863,7 +1949,7 @@ timeOW_t OneWireHub::waitLoopsCalibrate(void)
     timeOW_t time_for_reset = 0;
     timeOW_t repetitions = 10;
 
-    DIRECT_MODE_INPUT(pin_baseReg, pin_bitMask);
+    DIRECT_MODE_INPUT(pinBaseReg(), pin_bitMask);
 
     // repetitions the longest low-states on the bus with millis(), assume it is a OW-reset
     while (repetitions-- != 0)
@@ -917,11 +2003,18 @@ void OneWireHub::waitLoopsDebug(void) const
 {
     if (USE_SERIAL_DEBUG)
     {
+#if HUB_CYCLE_TIMING
+        Serial.println("DEBUG TIMINGS for the HUB (measured in cpu-cycles):");
+        Serial.print("value : \t");
+        Serial.print(VALUE1k / microsecondsToClockCycles(1));
+        Serial.println(" nanoseconds per cycle");
+#else
         Serial.println("DEBUG TIMINGS for the HUB (measured in loops):");
         Serial.println("(be sure to update VALUE_IPL in src/OneWireHub_config.h first!)");
         Serial.print("value : \t");
-        Serial.print(VALUE_IPL * VALUE1k / microsecondsToClockCycles(1));
+        Serial.print(HUB_VALUE_IPL * VALUE1k / microsecondsToClockCycles(1));
         Serial.println(" nanoseconds per loop");
+#endif
         Serial.print("reset min : \t");
         Serial.println(ONEWIRE_TIME_RESET_MIN[od_mode]);
         Serial.print("reset max : \t");
@@ -935,9 +2028,9 @@ void OneWireHub::waitLoopsDebug(void) const
         Serial.print("pres low max : \t");
         Serial.println(ONEWIRE_TIME_PRESENCE_MAX[od_mode]);
         Serial.print("msg hi timeout : \t");
-        Serial.println(ONEWIRE_TIME_MSG_HIGH_TIMEOUT);
+        Serial.println(timing.msg_high_timeout);
         Serial.print("slot max : \t");
-        Serial.println(ONEWIRE_TIME_SLOT_MAX[od_mode]);
+        Serial.println(timing.slot_max[od_mode]);
         Serial.print("read1low : \t");
         Serial.println(ONEWIRE_TIME_READ_MAX[od_mode]);
         Serial.print("read std : \t");
@@ -997,7 +2090,7 @@ void OneWireHub::printError(void) const
     }
 }
 
-Error OneWireHub::getError(void) const
+ONEWIRE_HOT Error OneWireHub::getError(void) const
 {
     return (_error);
 }
@@ -1007,13 +2100,194 @@ bool OneWireHub::hasError(void) const
     return (_error != Error::NO_ERROR);
 }
 
-void OneWireHub::raiseSlaveError(const uint8_t cmd)
+ONEWIRE_HOT void OneWireHub::raiseSlaveError(const uint8_t cmd)
 {
     _error = Error::INCORRECT_SLAVE_USAGE;
     _error_cmd = cmd;
 }
 
-Error OneWireHub::clearError(void) // and return it if needed
+// TRACE: one record is a few stores, the buffer overwrites the oldest records when it is not drained in time
+ONEWIRE_HOT void OneWireHub::trace(const TraceEvent event, const uint8_t value, const timeOW_t loops)
+{
+#if USE_TRACE
+#if USE_INTERRUPT_ENGINE
+    if (isrActive() && !isr_running)
+        return; // in interrupt-mode the buffer belongs to the ISR
+#endif
+    OneWireTraceRecord &record = trace_buffer[trace_head & (TRACE_SIZE - 1)];
+#if HUB_CYCLE_TIMING
+    record.time  = ONEWIRE_CYCLE_COUNT();
+#else
+    record.time  = micros();
+#endif
+    record.loops = loops;
+    record.event = static_cast<uint8_t>(event);
+    record.value = value;
+
+    trace_head = trace_head + 1;
+    if (static_cast<uint16_t>(trace_head - trace_tail) > TRACE_SIZE)
+    {
+        trace_tail = trace_tail + 1;
+        trace_dropped++;
+    }
+#else
+    (void) event;
+    (void) value;
+    (void) loops;
+#endif
+}
+
+bool OneWireHub::fetchTrace(OneWireTraceRecord &record)
+{
+#if USE_TRACE
+    noInterrupts(); // the interrupt-engine may write records
+    const bool available = (trace_head != trace_tail);
+    if (available)
+    {
+        record = trace_buffer[trace_tail & (TRACE_SIZE - 1)];
+        trace_tail = trace_tail + 1;
+    }
+    interrupts();
+    return available;
+#else
+    (void) record;
+    return false;
+#endif
+}
+
+// format: "trace-unit,<cycles|us>,<MHz>", "trace-dropped,<n>", then "trace,<event>,<value>,<time>,<loops>" per record
+void OneWireHub::printTrace(void)
+{
+#if USE_TRACE
+    Serial.print("trace-unit,");
+    Serial.print(HUB_CYCLE_TIMING ? "cycles," : "us,");
+    Serial.println(static_cast<uint32_t>(microsecondsToClockCycles(1)));
+    Serial.print("trace-dropped,");
+    Serial.println(trace_dropped);
+    trace_dropped = 0;
+
+    OneWireTraceRecord record;
+    while (fetchTrace(record))
+    {
+        Serial.print("trace,");
+        Serial.print(record.event);
+        Serial.print(',');
+        Serial.print(record.value);
+        Serial.print(',');
+        Serial.print(record.time);
+        Serial.print(',');
+        Serial.println(record.loops);
+    }
+#endif
+}
+
+// TELEMETRY: the record-FNs are called from the hot path, so they stay small and do nothing without USE_TELEMETRY
+#if USE_TELEMETRY
+// the counters stop at their maximum instead of wrapping, a duty-slot that wrapped to 0 would look unused
+static inline void countUp(uint16_t &counter)
+{
+    if (counter != 0xFFFF)
+        counter++;
+}
+#endif
+
+ONEWIRE_HOT void OneWireHub::recordError(void)
+{
+#if USE_TELEMETRY
+    if (_error != Error::NO_ERROR)
+        countUp(telemetry.error[static_cast<uint8_t>(_error) & (ERROR_COUNT - 1)]);
+#endif
+}
+
+ONEWIRE_HOT void OneWireHub::recordRomCmd(const uint8_t cmd)
+{
+#if USE_TELEMETRY
+    RomCmd index;
+    switch (cmd)
+    {
+        case 0xF0: index = RomCmd::SEARCH_ROM;          break;
+        case 0x55: index = RomCmd::MATCH_ROM;           break;
+        case 0xCC: index = RomCmd::SKIP_ROM;            break;
+        case 0xA5: index = RomCmd::RESUME;              break;
+        case 0x0F:
+        case 0x33: index = RomCmd::READ_ROM;            break;
+        case 0xEC: index = RomCmd::ALARM_SEARCH;        break;
+        case 0x69: index = RomCmd::OVERDRIVE_MATCH_ROM; break;
+        case 0x3C: index = RomCmd::OVERDRIVE_SKIP_ROM;  break;
+        default:   index = RomCmd::UNKNOWN;
+    }
+    countUp(telemetry.rom_cmd[static_cast<uint8_t>(index)]);
+#else
+    (void) cmd;
+#endif
+}
+
+// only the first byte after duty() started is the function-command of the item
+ONEWIRE_HOT void OneWireHub::recordDutyCmd(const uint8_t cmd)
+{
+    if (!duty_cmd_pending)
+        return;
+    duty_cmd_pending = false;
+    slave_selected->markCommand(cmd);
+
+#if USE_TELEMETRY
+    OneWireHubTelemetry::Duty &duty = telemetry.duty[slave_selected_number];
+    uint8_t slot = 0;
+    while ((slot < TELEMETRY_DUTY_CMDS) && (duty.count[slot] != 0) && (duty.cmd[slot] != cmd))
+        slot++;
+
+    if (slot < TELEMETRY_DUTY_CMDS)
+    {
+        duty.cmd[slot] = cmd;
+        countUp(duty.count[slot]);
+    }
+    else
+    {
+        countUp(duty.other);
+    }
+#endif
+}
+
+void OneWireHub::getTelemetry(OneWireHubTelemetry &snapshot) const
+{
+#if USE_TELEMETRY
+    // the interrupt-engine may update the counters, copy them in small parts to keep the masked time short
+    noInterrupts();
+    memcpy(snapshot.error, telemetry.error, sizeof(snapshot.error));
+    memcpy(snapshot.rom_cmd, telemetry.rom_cmd, sizeof(snapshot.rom_cmd));
+    interrupts();
+
+    for (uint8_t slave = 0; slave < HUB_SLAVE_LIMIT; ++slave)
+    {
+        noInterrupts();
+        snapshot.duty[slave] = telemetry.duty[slave];
+        interrupts();
+    }
+#else
+    snapshot = OneWireHubTelemetry();
+#endif
+}
+
+void OneWireHub::clearTelemetry(void)
+{
+#if USE_TELEMETRY
+    noInterrupts();
+    for (uint8_t index = 0; index < ERROR_COUNT; ++index)
+        telemetry.error[index] = 0;
+    for (uint8_t index = 0; index < ROM_CMD_COUNT; ++index)
+        telemetry.rom_cmd[index] = 0;
+    interrupts();
+
+    for (uint8_t slave = 0; slave < HUB_SLAVE_LIMIT; ++slave)
+    {
+        noInterrupts();
+        telemetry.duty[slave] = OneWireHubTelemetry::Duty();
+        interrupts();
+    }
+#endif
+}
+
+ONEWIRE_HOT Error OneWireHub::clearError(void) // and return it if needed
 {
     const Error _tmp = _error;
     _error = Error::NO_ERROR;
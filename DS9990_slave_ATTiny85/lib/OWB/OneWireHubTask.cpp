@@ -0,0 +1,181 @@
+#include "OneWireHubTask.h"
+
+#if USE_HUB_TASK && ONEWIRE_TASK_SUPPORT
+
+OneWireHubTask *OneWireHubTask::active = nullptr;
+
+OneWireHubTask::OneWireHubTask(OneWireHub &hub) : hub(hub)
+{
+    handle      = nullptr;
+    running     = false;
+    processed   = 0;
+    edge_time   = 0;
+    watch_count = 0;
+
+    for (uint8_t i = 0; i < HUB_TASK_WATCH_LIMIT; ++i)
+        watch_list[i] = Watch { nullptr, nullptr, 0, 0 };
+}
+
+bool OneWireHubTask::watch(OneWireItem &item, const OneWireMemoryFn reader, const uint8_t address, const uint8_t length)
+{
+    if ((watch_count >= HUB_TASK_WATCH_LIMIT) || running)
+        return false;
+
+    watch_list[watch_count++] = Watch { &item, reader, address, (length < HUB_TASK_MAIL_SIZE) ? length : HUB_TASK_MAIL_SIZE };
+    item.setCallback(onActivity);
+    return true;
+}
+
+bool OneWireHubTask::start(const uint8_t core, const uint8_t priority)
+{
+    if ((active != nullptr) || (handle != nullptr))
+        return false;
+
+    active    = this;
+    running   = true;
+    processed = 0;
+    if (xTaskCreatePinnedToCore(taskEntry, "onewire_hub", HUB_TASK_STACK_SIZE, this, priority, &handle, core) != pdPASS)
+    {
+        handle  = nullptr;
+        running = false;
+        active  = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void OneWireHubTask::stop(void)
+{
+    running = false;
+    while (handle != nullptr)
+        vTaskDelay(1);
+    active = nullptr;
+}
+
+bool OneWireHubTask::post(OneWireItem &item, const OneWireMemoryFn writer, const uint8_t address, const uint8_t data[], const uint8_t length)
+{
+    if ((writer == nullptr) || (length > HUB_TASK_MAIL_SIZE))
+        return false;
+
+    OneWireMail mail;
+    mail.item     = &item;
+    mail.function = writer;
+    mail.activity = OneWireActivity { 0, 0, 0, false };
+    mail.address  = address;
+    mail.length   = length;
+    memcpy(mail.data, data, length);
+    return mail_in.push(mail);
+}
+
+bool OneWireHubTask::fetch(OneWireMail &mail)
+{
+    return mail_out.pop(mail);
+}
+
+uint8_t OneWireHubTask::fetchDropped(void)
+{
+    return mail_out.fetchDropped();
+}
+
+uint32_t OneWireHubTask::getProcessed(void) const
+{
+    return processed;
+}
+
+void OneWireHubTask::taskEntry(void * const context)
+{
+    OneWireHubTask &task = *static_cast<OneWireHubTask *>(context);
+    task.handle = xTaskGetCurrentTaskHandle(); // the task may run before xTaskCreatePinnedToCore() returned the handle
+    task.run();
+    task.handle = nullptr;
+    vTaskDelete(nullptr);
+}
+
+// runs on the hub-core within runCallbacks() of the hub, the bus is idle
+void OneWireHubTask::onActivity(OneWireItem &item, const OneWireActivity &activity)
+{
+    OneWireHubTask * const task = active;
+    if (task == nullptr)
+        return;
+
+    for (uint8_t i = 0; i < task->watch_count; ++i)
+    {
+        const Watch &entry = task->watch_list[i];
+        if (entry.item != &item)
+            continue;
+
+        OneWireMail mail;
+        mail.item     = &item;
+        mail.function = nullptr;
+        mail.activity = activity;
+        mail.address  = entry.address;
+        mail.length   = entry.length;
+        if (entry.reader != nullptr)
+            entry.reader(item, mail);
+        task->mail_out.push(mail); // a full mailbox counts as dropped
+        return;
+    }
+}
+
+// the edge-interrupt is only enabled while the hub-task blocks on the idle bus
+void ONEWIRE_ISR_ATTR OneWireHubTask::onEdge(void * const context)
+{
+    OneWireHubTask &task = *static_cast<OneWireHubTask *>(context);
+    task.edge_time = micros();
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task.handle, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+void OneWireHubTask::run(void)
+{
+    const uint8_t    pin        = hub.getPinNumber();
+    const gpio_num_t gpio       = static_cast<gpio_num_t>(pin);
+    const TickType_t idle_ticks = (HUB_TASK_IDLE_MS >= portTICK_PERIOD_MS) ? (HUB_TASK_IDLE_MS / portTICK_PERIOD_MS) : 1;
+
+    // every timeslot masks the core on its own, the rtos-tick and other isrs get in between the slots
+    hub.setMaskScope(MaskScope::SLOT);
+    attachInterruptArg(pin, onEdge, this, FALLING);
+    gpio_intr_disable(gpio);
+
+    while (running)
+    {
+        // between two transactions, the master can't see the memory change in the middle of one
+        OneWireMail mail;
+        while (mail_in.pop(mail))
+            mail.function(*mail.item, mail);
+
+        // block on the idle bus until the master pulls it low, the edge-interrupt stays off while the task serves the bus
+        ulTaskNotifyTake(pdTRUE, 0); // drop a wake-up by an edge that was served already
+        edge_time = micros();         // a stale edge that fires on enabling can't pretend a long low state
+        gpio_intr_enable(gpio);
+        const bool bus_high = hub.getPinState();
+        const bool woken    = bus_high && (ulTaskNotifyTake(pdTRUE, idle_ticks) != 0);
+        gpio_intr_disable(gpio);
+
+        boolean hasProcessed = false;
+        if (woken && !hub.getPinState())
+        {
+            const uint32_t time_low_us = micros() - edge_time; // the wake-up took that long, it counts towards the reset
+            hub.pollFallingEdge(&hasProcessed, static_cast<uint16_t>((time_low_us < 0xFFFF) ? time_low_us : 0xFFFF));
+        }
+        else if (bus_high && !woken && hub.getPinState())
+        {
+            hub.runCallbacks(); // the bus stayed high for HUB_TASK_IDLE_MS
+        }
+        else
+        {
+            hub.poll(&hasProcessed, HUB_TASK_BUDGET_US); // the bus was low already (e.g. the next reset) or the edge was a glitch
+        }
+
+        if (hasProcessed)
+            processed = processed + 1;
+    }
+
+    detachInterrupt(pin);
+    hub.setMaskScope(MaskScope::CALL);
+}
+
+#endif
@@ -7,16 +7,168 @@
 /////////////////////////////////////////////////////
 
 // INFO: had to go with a define because some compilers use constexpr as simple const --> massive problems
-#define HUB_SLAVE_LIMIT     8 // set the limit of the hub HERE, max is 32 devices
-#define OVERDRIVE_ENABLE    0 // support overdrive for the slaves
+#ifndef HUB_SLAVE_LIMIT
+#define HUB_SLAVE_LIMIT     8 // set the limit of the hub HERE, max is 128 devices (each slave costs 2 tree-elements of RAM per tree)
+#endif
+#ifndef HUB_BUS_LIMIT
+#define HUB_BUS_LIMIT       4 // OneWireHubGroup: number of buses (one hub each) that can be served by one uC
+#endif
+#ifndef OVERDRIVE_ENABLE
+#define OVERDRIVE_ENABLE    0 // support overdrive for the slaves (items opt in with setOverdrive())
+#endif
+#ifndef USE_ALARM_SEARCH
+#define USE_ALARM_SEARCH    1 // answer ALARM SEARCH (0xEC), 0 saves the alarm-trees (a second copy of the id-tree RAM)
+#endif
+
+// pin of the bus, resolved at compile time: the hot loops poll a constant port-register with a constant mask (single instruction on avr)
+// 255 keeps the pin handed to the constructor. when set it has to match that pin. only for avr, esp8266 and esp32
+#ifndef HUB_STATIC_PIN
+#define HUB_STATIC_PIN      255
+#endif
+#define HUB_PIN_STATIC      ((HUB_STATIC_PIN != 255) && (ONEWIRE_STATIC_PIN_SUPPORT != 0))
+
+// ESP8266 / ESP32: execute the timing-critical FNs of the hub and the duty()-FNs of the items from IRAM instead of flash,
+// a cache-miss in a timeslot costs several microseconds. add "extra_scripts = post:iram_report.py" to print the used IRAM
+#ifndef USE_IRAM_HOT_PATH
+#define USE_IRAM_HOT_PATH   0
+#endif
+
+#if (USE_IRAM_HOT_PATH != 0) && defined(ONEWIRE_IRAM_ATTR)
+#define ONEWIRE_HOT         ONEWIRE_IRAM_ATTR
+#else
+#define ONEWIRE_HOT
+#endif
+
+// SEARCH ROM: precompute the (bit, complement)-pairs of every attached ID, the search only shifts them out (16 byte RAM per slave)
+// 0 shifts through the ID-bytes directly and generates the complement, same timing but no extra RAM (small avr)
+#ifndef USE_SEARCH_STREAM
+#define USE_SEARCH_STREAM   1
+#endif
+
+// CRC16 of send() / recv() with crc: 0 updates it bit by bit between the timeslots,
+// 1 (nibble-table, 32 byte) and 2 (byte-table, 512 byte) update it once per byte after the last bit of it
+// off on avr: the tables would end up in the sram
+#ifndef USE_CRC16_TABLE
+#if defined(__AVR__)
+#define USE_CRC16_TABLE     0
+#else
+#define USE_CRC16_TABLE     1
+#endif
+#endif
+
+// CRC8 of the items (ID, scratchpads, memory) on non-avr: 0 bit by bit, 1 two nibble-tables (32 byte), 2 byte-table (256 byte)
+// avr always uses the asm-version of the avr-libc, no table
+#ifndef USE_CRC8_TABLE
+#if defined(__AVR__)
+#define USE_CRC8_TABLE      0
+#else
+#define USE_CRC8_TABLE      1
+#endif
+#endif
+
+// counters for every error, rom-command and the function-commands of the items (see getTelemetry()), a few increments per transaction
+#ifndef USE_TELEMETRY
+#define USE_TELEMETRY       1
+#endif
+constexpr uint8_t  TELEMETRY_DUTY_CMDS { 4 }; // distinct function-commands counted per item, the rest goes to "other"
+
+// TRACE: the hub writes a record for each reset, presence, bit and duty() into a RAM ring-buffer, printTrace() drains it later
+// a record costs some cycles in the timeslot, not the milliseconds of serial debug. decode the output with trace_decode.py
+#ifndef USE_TRACE
+#define USE_TRACE           0
+#endif
+#ifndef TRACE_SIZE
+#define TRACE_SIZE          128 // records, has to be a power of 2, 12 byte each
+#endif
+
+// ADAPTIVE TIMING: the hub measures the timeslots of the master and tightens SLOT_MAX and MSG_HIGH_TIMEOUT after
+// some error-free transactions (normal speed, poll()-modes). an error brings back the wide values of this file
+#ifndef USE_ADAPTIVE_TIMING
+#define USE_ADAPTIVE_TIMING 0
+#endif
+constexpr uint8_t  TIMING_LEARN_TRANSACTIONS { 16 };
+
+// PERIOD: the hub learns the polling period of the master from the first reset of each burst (see timeUntilNextExpectedReset())
+constexpr uint32_t RESET_BURST_GAP_US        { 20000 }; // resets closer than this belong to the same poll of the master
+constexpr uint8_t  PERIOD_LEARN_SAMPLES      { 8 };     // periods until the confidence is not limited by the count anymore
+
+// GROUP: OneWireHubGroup runs the callbacks of a bus once it stayed high this long, like ONEWIRE_TIME_RESET_TIMEOUT of poll()
+constexpr uint32_t GROUP_IDLE_US             { 5000 };
+
+// SLEEP: pollSleep() lets the mcu sleep on an idle bus until the master pulls it low (see sleepUntilBusLow() in platform.cpp)
+// a fast wake-up catches the reset by its edge. a slow one (esp8266 light sleep) would miss it, so the hub only sleeps
+// while the next poll of the master is predicted (see timeUntilNextExpectedReset()) and wakes up by timer before it.
+// EXPERIMENTAL: the wake-up latencies in platform.h are not measured yet (see README)
+#ifndef USE_SLEEP
+#define USE_SLEEP           0
+#endif
+constexpr uint32_t SLEEP_EDGE_LATENCY_MAX_US { 100 };  // a wake-up up to this long still measures enough of the reset
+constexpr uint32_t SLEEP_GUARD_US            { 2000 }; // slow wake-up: be awake this long before the predicted reset
+constexpr uint8_t  SLEEP_CONFIDENCE          { 128 };  // slow wake-up: the prediction has to be at least this good
+
+// TASK: OneWireHubTask runs the hub on its own core of a dual-core esp32, the application talks to it through mailboxes
+// EXPERIMENTAL: the masking and the wake-up latency are not verified on hardware yet, so it has to be switched on
+#ifndef USE_HUB_TASK
+#define USE_HUB_TASK        0
+#endif
+constexpr uint8_t  HUB_TASK_CORE        { 1 };     // app-cpu, wifi and bluetooth stay on core 0
+constexpr uint8_t  HUB_TASK_PRIORITY    { 20 };    // above everything the application pins to the same core
+constexpr uint32_t HUB_TASK_STACK_SIZE  { 4096 };  // bytes
+constexpr uint32_t HUB_TASK_BUDGET_US   { 1000 };  // wait for a reset if the bus was low already when the hub-task got to it
+constexpr uint32_t HUB_TASK_IDLE_MS     { 10 };    // the hub-task wakes up after this long of idle bus to run the callbacks
+constexpr uint8_t  HUB_TASK_QUEUE_SIZE  { 8 };     // mails per direction, has to be a power of 2
+constexpr uint8_t  HUB_TASK_MAIL_SIZE   { 16 };    // bytes of item memory per mail
+constexpr uint8_t  HUB_TASK_WATCH_LIMIT { 4 };     // items that report their activity to the application
+
+// INTERRUPT-ENGINE: the ISR decodes the timeslots, the loop serves the transaction in fetchProcessed()
+#ifndef USE_INTERRUPT_ENGINE
+#define USE_INTERRUPT_ENGINE 1 // 0 removes startInterruptMode() with its two queues and state (~85 byte RAM on AVR)
+#endif
+constexpr uint8_t  ISR_QUEUE_SIZE      { 32 }; // bits per direction the loop may fall behind, has to be a power of 2
+
+// SNIFFER: sniff() decodes the traffic of the bus without driving it, each transaction goes into a queue
+constexpr uint8_t  SNIFFER_DATA_SIZE   { 16 }; // bytes after the rom-part that are stored per transaction
+constexpr uint8_t  SNIFFER_QUEUE_SIZE  { 8 };  // transactions, has to be a power of 2
 
 constexpr bool     USE_SERIAL_DEBUG { false }; // give debug messages when printError() is called (be aware! it may produce heisenbugs, timing is critical) SHOULD NOT be enabled with < 20 MHz uC
 constexpr bool     USE_GPIO_DEBUG   { false }; // is a better alternative to serial debug (see readme.md for info) SHOULD NOT be enabled with < 20 MHz uC and Overdrive enabled
 constexpr uint8_t  GPIO_DEBUG_PIN   { 7 }; // digital pin
 constexpr uint32_t REPETITIONS      { 5000 }; // for measuring the loop-delay --> 10000L takes ~110ms on atmega328p@16Mhz
 
+// TIMING UNIT: the literal "_us" converts microseconds into the unit of the wait-loops
+#if HUB_PIN_STATIC
+constexpr uint8_t HUB_VALUE_IPL { VALUE_IPL_STATIC_PIN }; // the shorter loop needs its own calibration (see platform.h)
+#else
+constexpr uint8_t HUB_VALUE_IPL { VALUE_IPL };
+#endif
+
+using     timeOW_t            = uint32_t;
+constexpr timeOW_t timeOW_max = 4294967295; // will arduino-gcc ever offer some stl? std::numeric_limits::max would be cleaner
+
+// the unit of timeOW_t depends on the timing-backend (see platform.h): cpu-cycles with HUB_CYCLE_TIMING, otherwise loops
+constexpr timeOW_t operator "" _us(const unsigned long long int time_us) // user defined literal used in config
+{
+#if HUB_CYCLE_TIMING
+    return timeOW_t(time_us * microsecondsToClockCycles(1));
+#else
+    return timeOW_t(time_us * microsecondsToClockCycles(1) / HUB_VALUE_IPL); // note: microsecondsToClockCycles == speed in MHz....
+#endif
+    // TODO: overflow detection would be nice, but literals are allowed with return-only, not solvable ATM
+}
+
+
+// same FN, but not as literal
+constexpr timeOW_t timeUsToLoops(const uint16_t time_us)
+{
+#if HUB_CYCLE_TIMING
+    return (time_us * microsecondsToClockCycles(1));
+#else
+    return (time_us * microsecondsToClockCycles(1) / HUB_VALUE_IPL); // note: microsecondsToClockCycles == speed in MHz....
+#endif
+}
+
 static_assert(!(USE_SERIAL_DEBUG && (microsecondsToClockCycles(1) < 20)), "Serial debug is enabled in OW-Config. SHOULD NOT be enabled with < 20 MHz uC");
-static_assert(!(USE_GPIO_DEBUG && (microsecondsToClockCycles(1) < 20) && (OVERDRIVE_ENABLE != 0)), "Gpio debug is enabled in OW-Config. SHOULD NOT be enabled with < 20 MHz uC and Overdrive enabled");
+constexpr bool     GPIO_DEBUG_OVERDRIVE { microsecondsToClockCycles(1) >= 20 }; // slower uC leave the debug-pin alone while in overdrive, the timeslots are too short
 
 /// the following TIME-values are in microseconds and are taken mostly from the ds2408 datasheet
 //  arrays contain the normal timing value and the overdrive-value, the literal "_us" converts the value right away to a usable unit
@@ -42,6 +194,13 @@ constexpr timeOW_t ONEWIRE_TIME_READ_MIN[2]          = {    20_us,  4_us }; // s
 constexpr timeOW_t ONEWIRE_TIME_READ_MAX[2]          = {    60_us, 10_us }; // low states (zeros) of a master should not exceed this time in a slot
 constexpr timeOW_t ONEWIRE_TIME_WRITE_ZERO[2]        = {    30_us,  8_us }; // the hub holds a zero for this long
 
+// Interrupt-engine: the ISR measures the low states with timestamps of ONEWIRE_ISR_CLOCK() (see platform.h) instead of wait-loops
+constexpr uint32_t timeUsToIsrClock(const uint32_t time_us) { return HUB_CYCLE_TIMING ? (time_us * microsecondsToClockCycles(1)) : time_us; }
+constexpr uint32_t ONEWIRE_ISR_READ_MIN[2]           = { timeUsToIsrClock(20),  timeUsToIsrClock(4) };  // shorter low states are ones, like ONEWIRE_TIME_READ_MIN
+constexpr uint32_t ONEWIRE_ISR_RESET_MIN[2]          = { timeUsToIsrClock(430), timeUsToIsrClock(48) };
+constexpr uint32_t ONEWIRE_ISR_RESET_MAX             = { timeUsToIsrClock(960) };
+constexpr uint16_t ONEWIRE_ISR_TIMEOUT_US            = { 15000 };                    // the loop waits this long for a timeslot, like ONEWIRE_TIME_MSG_HIGH_TIMEOUT
+
 // VALUES FOR STATIC ASSERTS
 constexpr timeOW_t ONEWIRE_TIME_VALUE_MAX            = { ONEWIRE_TIME_MSG_HIGH_TIMEOUT };
 constexpr timeOW_t ONEWIRE_TIME_VALUE_MIN            = { ONEWIRE_TIME_READ_MIN[OVERDRIVE_ENABLE] };
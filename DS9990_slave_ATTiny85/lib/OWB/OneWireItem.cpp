@@ -1,4 +1,7 @@
 #include "OneWireItem.h"
+#include "OneWireHub_crc.h"
+
+volatile uint8_t OneWireItem::alarm_changes = 0;
 
 OneWireItem::OneWireItem(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uint8_t ID5, uint8_t ID6, uint8_t ID7)
 {
@@ -10,12 +13,107 @@ OneWireItem::OneWireItem(uint8_t ID1, uint8_t ID2, uint8_t ID3, uint8_t ID4, uin
     ID[5] = ID6;
     ID[6] = ID7;
     ID[7] = crc8(ID, 7);
+
+    alarm_flag = false;
+    od_capable = false;
+
+    activity = OneWireActivity();
+    activity_flag = false;
+    callback = nullptr;
 }
 
-void OneWireItem::sendID(OneWireHub * const hub) const {
+ONEWIRE_HOT void OneWireItem::sendID(OneWireHub * const hub) const {
     hub->send(ID, 8);
 }
 
+void OneWireItem::setAlarm(const bool value)
+{
+    if (alarm_flag == value)
+        return;
+    alarm_flag = value;
+    alarm_changes = static_cast<uint8_t>(alarm_changes + 1);
+}
+
+bool OneWireItem::getAlarm(void) const
+{
+    return alarm_flag;
+}
+
+void OneWireItem::setOverdrive(const bool value)
+{
+    od_capable = value;
+}
+
+bool OneWireItem::getOverdrive(void) const
+{
+    return od_capable;
+}
+
+void OneWireItem::setCallback(const OneWireCallback function)
+{
+    callback = function;
+}
+
+bool OneWireItem::hasActivity(void) const
+{
+    return activity_flag;
+}
+
+bool OneWireItem::fetchActivity(OneWireActivity &result)
+{
+    if (!activity_flag)
+        return false;
+
+    result = activity;
+    activity = OneWireActivity();
+    activity_flag = false;
+    return true;
+}
+
+void OneWireItem::runCallback(void)
+{
+    if (callback == nullptr)
+        return;
+
+    OneWireActivity result;
+    if (fetchActivity(result))
+        callback(*this, result);
+}
+
+ONEWIRE_HOT void OneWireItem::markCommand(const uint8_t cmd)
+{
+    activity.cmd = cmd;
+    activity_flag = true;
+}
+
+ONEWIRE_HOT void OneWireItem::markWrite(const uint8_t position, const uint8_t length)
+{
+    if (length == 0)
+        return;
+
+    const uint8_t end = static_cast<uint8_t>(position + length);
+    if (activity.write_start == activity.write_end)
+    {
+        activity.write_start = position;
+        activity.write_end   = end;
+    }
+    else
+    {
+        // several writes since the last fetch, report the range covering all of them
+        if (position < activity.write_start)
+            activity.write_start = position;
+        if (end > activity.write_end)
+            activity.write_end = end;
+    }
+    activity_flag = true;
+}
+
+ONEWIRE_HOT void OneWireItem::markRead(void)
+{
+    activity.read = true;
+    activity_flag = true;
+}
+
 //The CRC code was excerpted and inspired by the Dallas Semiconductor
 //sample code bearing this copyright.
 //---------------------------------------------------------------------------
@@ -50,10 +148,11 @@ void OneWireItem::sendID(OneWireHub * const hub) const {
 //  https://github.com/PaulStoffregen/OneWire/blob/master/OneWire.cpp --> calc with table (EOF)
 
 
-// INFO: this is the slow but memory saving version of the CRC() --> the calculation is not time-critical and happens offline
+// INFO: the bitwise version is the slow but memory saving version of the CRC(), USE_CRC8_TABLE selects a lookup-table instead
+// it matters for items that send the crc right after their data (e.g. DS9990), the master sees the calculation as a gap
 // alternative for AVR: http://www.atmel.com/webdoc/AVRLibcReferenceManual/group__util__crc_1ga37b2f691ebbd917e36e40b096f78d996.html
 
-uint8_t OneWireItem::crc8(const uint8_t data[], const uint8_t data_size, const uint8_t crc_init)
+ONEWIRE_HOT uint8_t OneWireItem::crc8(const uint8_t data[], const uint8_t data_size, const uint8_t crc_init)
 {
     uint8_t crc = crc_init;
 
@@ -61,6 +160,8 @@ uint8_t OneWireItem::crc8(const uint8_t data[], const uint8_t data_size, const u
     {
 #if defined(__AVR__)
         crc = _crc_ibutton_update(crc, data[index]);
+#elif (USE_CRC8_TABLE != 0)
+        crc = crc8Update(crc, data[index]);
 #else
         uint8_t inByte = data[index];
         for (uint8_t bitPosition = 0; bitPosition < 8; ++bitPosition)
@@ -76,7 +177,7 @@ uint8_t OneWireItem::crc8(const uint8_t data[], const uint8_t data_size, const u
 }
 
 
-uint16_t OneWireItem::crc16(const uint8_t address[], const uint8_t length, const uint16_t init)
+ONEWIRE_HOT uint16_t OneWireItem::crc16(const uint8_t address[], const uint8_t length, const uint16_t init)
 {
     uint16_t crc = init; // init value
 
@@ -109,7 +210,7 @@ uint16_t OneWireItem::crc16(const uint8_t address[], const uint8_t length, const
     return crc;
 }
 
-uint16_t OneWireItem::crc16(uint8_t value, uint16_t crc)
+ONEWIRE_HOT uint16_t OneWireItem::crc16(uint8_t value, uint16_t crc)
 {
 #if defined(__AVR__)
     return _crc16_update(crc, value);
@@ -13,6 +13,21 @@
 // - var 3: rewrite the OneWireItem-Class and implement something like setFamilyCode()
 // - var 4: make public family_code in sensor mandatory and just put it into init() if wanted --> prefer this
 
+// what duty() did since the last fetch. the hub marks the function-command of every item, the accesses to the memory
+// are only known to items that mark them (see markWrite() and markRead(), DS9990 so far)
+struct OneWireActivity
+{
+    uint8_t cmd;         // last function-command, first byte received by duty()
+    uint8_t write_start; // first written byte of the memory
+    uint8_t write_end;   // behind the last written byte, equal to write_start if nothing was written
+    bool    read;        // the master read (a part of) the memory
+};
+
+class OneWireItem;
+
+// runs after the bus went idle, outside of the timing-critical part (see OneWireHub::runCallbacks())
+using OneWireCallback = void (*)(OneWireItem &item, const OneWireActivity &activity);
+
 class OneWireItem
 {
 public:
@@ -31,8 +46,23 @@ public:
 
     void sendID(OneWireHub * hub) const;
 
+    // item shows up in an ALARM SEARCH (0xEC) of the master, e.g. when there is new data
+    void setAlarm(bool value = true);
+    bool getAlarm(void) const;
+    static volatile uint8_t alarm_changes; // counts the changes of all items, the hubs only rescan their alarm-flags after one
+
+    // item takes part in OVERDRIVE SKIP / MATCH ROM (0x3C / 0x69), has to be set before attaching it to the hub
+    void setOverdrive(bool value = true);
+    bool getOverdrive(void) const;
+
     virtual void duty(OneWireHub * hub) = 0;
 
+    // activity is merged until it is fetched, a callback fetches it on its own
+    void setCallback(OneWireCallback function);
+    bool hasActivity(void) const;
+    bool fetchActivity(OneWireActivity &result); // returns false if nothing happened
+    void runCallback(void);                      // called by the hub, does nothing without callback or activity
+
     static uint8_t crc8(const uint8_t data[], uint8_t data_size, uint8_t crc_init = 0);
 
     // takes ~(5.1-7.0)µs/byte (Atmega328P@16MHz) depends from address_size (see debug-crc-comparison.ino)
@@ -44,6 +74,24 @@ public:
     // important: the final crc is expected to be inverted (crc=~crc) !!!
     static uint16_t crc16(uint8_t value, uint16_t crc);
 
+protected:
+
+    // for duty(): keep it short, these run between the timeslots
+    void markWrite(uint8_t position, uint8_t length);
+    void markRead(void);
+
+private:
+
+    friend class OneWireHub;
+    void markCommand(uint8_t cmd); // by the hub, for every item (see OneWireHub::recordDutyCmd())
+
+    volatile bool alarm_flag;
+    bool          od_capable;
+
+    OneWireActivity  activity;
+    volatile bool    activity_flag;
+    OneWireCallback  callback;
+
 };
 
 
@@ -0,0 +1,69 @@
+// lock-free queue for one producer and one consumer (e.g. ISR or hub -> loop()), no interrupts are masked
+// the producer only writes head, the consumer only writes tail. both are single bytes, so every uC stores them atomically
+
+#ifndef ONEWIREHUB_QUEUE_H
+#define ONEWIREHUB_QUEUE_H
+
+#include "platform.h"
+
+template<typename T, uint8_t size>
+class OneWireQueue
+{
+private:
+
+    static_assert((size != 0) && ((size & (size - 1)) == 0) && (size <= 128), "size of the queue has to be a power of 2 and <= 128");
+
+    T                buffer[size];
+    volatile uint8_t head;    // next element to write
+    volatile uint8_t tail;    // next element to read
+    volatile uint8_t dropped; // push() on a full queue, only written by the producer
+    uint8_t          dropped_seen; // only written by the consumer
+
+public:
+
+    OneWireQueue(void) : head(0), tail(0), dropped(0), dropped_seen(0) { };
+
+    // producer: returns false if the queue is full
+    bool push(const T &value)
+    {
+        const uint8_t position = head;
+        if (static_cast<uint8_t>(position - tail) >= size)
+        {
+            dropped = static_cast<uint8_t>(dropped + 1);
+            return false;
+        }
+        buffer[position & (size - 1)] = value;
+        ONEWIRE_MEMORY_BARRIER(); // element has to be complete before it is visible
+        head = static_cast<uint8_t>(position + 1);
+        return true;
+    }
+
+    // consumer: returns false if the queue is empty
+    bool pop(T &value)
+    {
+        const uint8_t position = tail;
+        if (head == position)
+            return false;
+        ONEWIRE_MEMORY_BARRIER();
+        value = buffer[position & (size - 1)];
+        ONEWIRE_MEMORY_BARRIER(); // element has to be read before the producer may overwrite it
+        tail = static_cast<uint8_t>(position + 1);
+        return true;
+    }
+
+    uint8_t getCount(void) const
+    {
+        return static_cast<uint8_t>(head - tail);
+    }
+
+    // consumer: number of lost elements since the last call (modulo 256)
+    uint8_t fetchDropped(void)
+    {
+        const uint8_t value = dropped;
+        const uint8_t count = static_cast<uint8_t>(value - dropped_seen);
+        dropped_seen = value;
+        return count;
+    }
+};
+
+#endif //ONEWIREHUB_QUEUE_H
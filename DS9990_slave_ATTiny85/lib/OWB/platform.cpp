@@ -1,9 +1,303 @@
 #include "platform.h"
+#include "OneWireHub_config.h"
 
-#ifdef ONEWIREHUB_FALLBACK_BASIC_FNs
+#if defined(ONEWIREHUB_HOST)
+
+namespace
+{
+    struct HostWire
+    {
+        bool         output;     // hub: pin in output-mode
+        bool         latch_high; // hub: level of the output
+        HostWire    *bus;        // pin is connected to this bus, nullptr: the pin is a bus of its own
+        uint8_t      pulls_low;  // bus: number of connected pins that pull it low
+        HostMasterFn master;
+        void        *context;
+    };
+
+    struct HostInterrupt
+    {
+        uint32_t     pin;
+        void       (*handler)(void);
+        int          mode;
+        bool         level;          // last level the edge-detection saw
+    };
+
+    constexpr uint8_t HOST_INTERRUPT_LIMIT { 4 };
+
+    HostWire      host_wire[256];
+    HostInterrupt host_interrupt[HOST_INTERRUPT_LIMIT];
+    uint64_t      host_clock { 0 };
+    HostYieldFn   host_yield { nullptr };
+    bool          host_masked { false };    // noInterrupts()
+    bool          host_in_isr { false };    // no nested interrupts, like on most uC
+    uint8_t       host_interrupt_count { 0 };
+
+    HostWire &busOf(HostWire &wire)
+    {
+        return (wire.bus != nullptr) ? *wire.bus : wire;
+    }
+
+    void drive(HostWire &wire, const bool output, const bool latch_high)
+    {
+        const bool low_before = wire.output && !wire.latch_high;
+        wire.output     = output;
+        wire.latch_high = latch_high;
+        const bool low_after = wire.output && !wire.latch_high;
+        if (low_before && !low_after) busOf(wire).pulls_low--;
+        if (!low_before && low_after) busOf(wire).pulls_low++;
+    }
+
+    // edge-detection of the pin-interrupts, runs whenever the clock moved (the hardware checks between two instructions)
+    void serviceInterrupts(void)
+    {
+        if (host_masked || host_in_isr)
+            return;
+
+        for (uint8_t i = 0; i < host_interrupt_count; ++i)
+        {
+            HostInterrupt &entry = host_interrupt[i];
+            const bool level = hostWireLevel(entry.pin);
+            if (level == entry.level)
+                continue;
+            entry.level = level;
+            if ((entry.mode == CHANGE) || ((entry.mode == FALLING) && !level) || ((entry.mode == RISING) && level))
+            {
+                host_in_isr = true;
+                entry.handler();
+                host_in_isr = false;
+            }
+        }
+    }
+}
+
+uint32_t hostClockCycles(void)
+{
+    return static_cast<uint32_t>(host_clock);
+}
+
+uint64_t hostClockTime(void)
+{
+    return host_clock;
+}
+
+void hostClockAdvance(const uint32_t cycles)
+{
+    host_clock += cycles;
+}
+
+void hostClockSetYield(const HostYieldFn yield)
+{
+    host_yield = yield;
+}
+
+void hostClockIdle(void)
+{
+    if (host_yield != nullptr) host_yield();
+    else                       host_clock += VALUE_IPL;
+    serviceInterrupts();
+}
+
+void hostClearInterrupt(const uint32_t pin)
+{
+    for (uint8_t i = 0; i < host_interrupt_count; ++i)
+    {
+        if (host_interrupt[i].pin == pin)
+            host_interrupt[i].level = hostWireLevel(pin);
+    }
+}
+
+void attachInterrupt(const int interrupt, void (* const handler)(void), const int mode)
+{
+    detachInterrupt(interrupt);
+    if (host_interrupt_count >= HOST_INTERRUPT_LIMIT)
+        return;
+    const uint32_t pin = static_cast<uint32_t>(interrupt) & 0xFF;
+    host_interrupt[host_interrupt_count++] = HostInterrupt { pin, handler, mode, hostWireLevel(pin) };
+}
+
+void detachInterrupt(const int interrupt)
+{
+    const uint32_t pin = static_cast<uint32_t>(interrupt) & 0xFF;
+    for (uint8_t i = host_interrupt_count; i > 0; --i)
+    {
+        if (host_interrupt[i - 1].pin == pin)
+            host_interrupt[i - 1] = host_interrupt[--host_interrupt_count];
+    }
+}
+
+bool hostInterruptsMasked(void)
+{
+    return host_masked;
+}
+
+void cli() { host_masked = true; };
+void sei() { host_masked = false; serviceInterrupts(); };
+
+void noInterrupts() { cli(); };
+
+void interrupts() { sei(); };
+
+void hostWireAttachMaster(const uint32_t pin, const HostMasterFn master, void * const context)
+{
+    host_wire[pin & 0xFF].master  = master;
+    host_wire[pin & 0xFF].context = context;
+}
+
+void hostWireConnect(const uint32_t pin, const uint32_t bus_pin)
+{
+    HostWire &wire = host_wire[pin & 0xFF];
+    HostWire &bus  = busOf(host_wire[bus_pin & 0xFF]);
+    const bool output = wire.output;
+    drive(wire, false, wire.latch_high); // release the old bus
+    wire.bus = (&bus == &wire) ? nullptr : &bus;
+    drive(wire, output, wire.latch_high);
+}
+
+// open drain: the bus is high unless a hub or the master pulls it low
+bool hostWireLevel(const uint32_t pin)
+{
+    const HostWire &bus = busOf(host_wire[pin & 0xFF]);
+    const bool slave_level = (bus.pulls_low == 0);
+    const bool master_low  = (bus.master != nullptr) && bus.master(bus.context, host_clock, slave_level);
+    return slave_level && !master_low;
+}
+
+bool hostWireRead(const uint32_t pin)
+{
+    hostClockIdle();
+    return hostWireLevel(pin);
+}
+
+void hostWireMode(const uint32_t pin, const bool output)
+{
+    HostWire &wire = host_wire[pin & 0xFF];
+    drive(wire, output, wire.latch_high);
+}
+
+void hostWireWrite(const uint32_t pin, const bool value)
+{
+    HostWire &wire = host_wire[pin & 0xFF];
+    drive(wire, wire.output, value);
+}
+
+uint32_t micros() { return static_cast<uint32_t>(host_clock / microsecondsToClockCycles(1)); };
+uint32_t millis() { return static_cast<uint32_t>(host_clock / microsecondsToClockCycles(1000)); };
+
+void delay(const uint32_t time_millis)
+{
+    const uint64_t time_end = host_clock + static_cast<uint64_t>(time_millis) * microsecondsToClockCycles(1000);
+    if (host_yield == nullptr) host_clock = time_end;
+    while (host_clock < time_end) host_yield(); // the other participants keep running
+};
+
+bool sleepUntilBusLow(const uint8_t pin_number, const uint32_t timeout_us)
+{
+    if (!hostWireLevel(pin_number))
+        return false;
+
+    const uint64_t time_end = host_clock + static_cast<uint64_t>(timeout_us) * microsecondsToClockCycles(1);
+    while (hostWireRead(pin_number))
+    {
+        if ((timeout_us != 0) && (host_clock >= time_end))
+            return true;
+    }
+
+    // the wake-up takes time, the master keeps the bus low meanwhile
+    const uint64_t time_awake = host_clock + static_cast<uint64_t>(ONEWIRE_WAKE_LATENCY_US) * microsecondsToClockCycles(1);
+    while (host_clock < time_awake)
+        hostClockIdle();
+    return true;
+}
+
+void wdt_reset() { };
+void wdt_enable(...) { };
+
+#elif (USE_SLEEP != 0) && (defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__))
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+// the wake-up is all that is needed, the hub measures the low state itself. SoftwareSerial claims this vector as well
+EMPTY_INTERRUPT(PCINT0_vect);
+
+bool sleepUntilBusLow(const uint8_t pin_number, const uint32_t timeout_us)
+{
+    (void)timeout_us; // power-down stops the timers, the edge is the only wake-up (fast enough for the reset)
+
+    const uint8_t adc_state = ADCSRA;
+    ADCSRA &= static_cast<uint8_t>(~_BV(ADEN)); // the adc would draw more than the sleeping core
+
+    bool slept = false;
+    cli();
+    PCMSK |= _BV(pin_number);
+    GIFR   = _BV(PCIF); // edges of the last transaction
+    GIMSK |= _BV(PCIE);
+    if ((PINB & _BV(pin_number)) != 0)
+    {
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        sleep_enable();
+        sei();
+        sleep_cpu(); // sei() always runs the next instruction, an edge right before ends the sleep at once
+        sleep_disable();
+        slept = true;
+    }
+    sei();
+    GIMSK &= static_cast<uint8_t>(~_BV(PCIE));
+    PCMSK &= static_cast<uint8_t>(~_BV(pin_number));
+
+    ADCSRA = adc_state;
+    return slept;
+}
+
+#elif (USE_SLEEP != 0) && defined(ARDUINO_ARCH_ESP8266)
+
+#include <coredecls.h> // esp_delay()
+extern "C" {
+#include "user_interface.h"
+#include "gpio.h"
+}
+
+namespace
+{
+    volatile bool sleep_woken { false };
+
+    void sleepWakeup(void)
+    {
+        sleep_woken = true;
+    }
+}
+
+bool sleepUntilBusLow(const uint8_t pin_number, const uint32_t timeout_us)
+{
+    // forced light sleep: the sdk takes 10 ms as the shortest timer, 0xFFFFFFF means gpio only
+    if (((timeout_us != 0) && (timeout_us < 10000)) || (digitalRead(pin_number) == LOW))
+        return false;
+
+    wifi_set_opmode_current(NULL_MODE);
+    wifi_fpm_set_sleep_type(LIGHT_SLEEP_T);
+    wifi_fpm_open();
+    wifi_fpm_set_wakeup_cb(sleepWakeup);
+    gpio_pin_wakeup_enable(GPIO_ID_PIN(pin_number), GPIO_PIN_INTR_LOLEVEL);
+
+    sleep_woken = false;
+    wifi_fpm_do_sleep((timeout_us != 0) ? timeout_us : 0xFFFFFFF);
+    // the core enters the sleep while it idles in esp_delay(), the wake-up callback ends the wait
+    esp_delay((timeout_us != 0) ? (timeout_us / 1000 + 1) : 0xFFFFFFFF, []() { return !sleep_woken; });
+
+    gpio_pin_wakeup_disable();
+    wifi_fpm_close();
+    return true;
+}
+
+#elif defined(ONEWIREHUB_FALLBACK_BASIC_FNs)
 
 uint32_t micros() { return 0; }; // original arduino-fn takes about 3 µs to process @ 16 MHz
 
+#endif
+
+#if defined(ONEWIREHUB_FALLBACK_BASIC_FNs) && !defined(ONEWIREHUB_HOST)
+
 void cli() { };
 void sei() { };
 
@@ -13,3 +307,9 @@ void interrupts() { };
 
 #endif // ONEWIREHUB_FALLBACK_BASIC_FNs
 
+#ifdef ONEWIREHUB_FALLBACK_ADDITIONAL_FNs
+
+serial Serial;
+
+#endif // ONEWIREHUB_FALLBACK_ADDITIONAL_FNs
+
@@ -18,6 +18,10 @@ constexpr uint8_t pin_onewire{3};
 
 uint32_t i_loop = 0;
 uint32_t lastDhtReading = -4000;
+#if USE_SLEEP
+// millis() stands still in power-down, the master polls every 500 ms (SAMPLE_PERIOD of the DS9990_master)
+constexpr uint32_t dht_read_transactions{8};
+#endif
 
 auto hub = OneWireHub(pin_onewire);
 
@@ -122,7 +126,11 @@ void loop()
 {
   boolean hasProcessed = false;
   // following function must be called periodically
+#if USE_SLEEP
+  hub.pollSleep(&hasProcessed); // power-down until the master pulls the bus low (see platformio.ini)
+#else
   hub.poll(&hasProcessed);
+#endif
   if (hasProcessed)
   {
     //Serial.printf("hasProcessed = %d / millis = %d\n", hasProcessed, millis());
@@ -142,7 +150,11 @@ void loop()
     digitalWrite(4, val[0]);
 
     // read temperature and humidity from DHT
+#if USE_SLEEP
+    if ((i_loop % dht_read_transactions) == 0)
+#else
     if (millis() > lastDhtReading + 4000)
+#endif
     {
       //readDhtNonBlocking();
       readDhtBlocking();
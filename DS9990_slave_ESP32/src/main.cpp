@@ -0,0 +1,145 @@
+/*
+ *    DS9990_slave for a dual-core ESP32
+ *    - the hub runs in OneWireHubTask on core 1, the interrupts of that core are masked per timeslot
+ *      and the task blocks until the master pulls the bus low
+ *    - DHT, analog reads (and wifi, if added) run on core 0, blocking there doesn't cost a transaction
+ *    - the memory of the DS9990 is only touched on core 1: writes are posted, the activity comes back as mail
+ *    - EXPERIMENTAL: OneWireHubTask is only built with USE_HUB_TASK=1 (see platformio.ini), not run on hardware yet
+ *
+ *    memory: byte 0 brake (written by the master), 1-2 temperature, 3-4 humidity, 5-6 current (all x10, little endian)
+ */
+
+#include "OneWireHub.h"
+#include "OneWireHubTask.h"
+#include "DS9990.h" // Custom SE_EB
+#include "DHT.h"
+
+#if !USE_HUB_TASK
+#error "OneWireHubTask is experimental, enable it with -DUSE_HUB_TASK=1"
+#endif
+
+#define DEBUG 0
+
+constexpr uint8_t pin_led{2};
+constexpr uint8_t pin_brake{26};
+constexpr uint8_t pin_current{34};
+constexpr uint8_t pin_onewire{4};
+constexpr uint8_t pin_dht{27};
+constexpr uint8_t app_core{0};
+constexpr uint32_t dht_interval_ms{4000}; // the DHT22 delivers new values every 2 s at best
+
+auto hub = OneWireHub(pin_onewire);
+auto hub_task = OneWireHubTask(hub);
+
+auto ds9990 = DS9990(DS9990::family_code, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14);
+
+DHT dht(pin_dht, DHT22);
+
+// these run on the hub-core while the bus is idle
+void readDs9990(OneWireItem &item, OneWireMail &mail)
+{
+  static_cast<DS9990 &>(item).readMemory(mail.data, mail.length, mail.address);
+}
+
+void writeDs9990(OneWireItem &item, OneWireMail &mail)
+{
+  static_cast<DS9990 &>(item).writeMemory(mail.data, mail.length, mail.address);
+}
+
+void postValues(const float temperature, const float humidity)
+{
+  const int16_t temp_int = temperature * 10;
+  const int16_t hum_int = humidity * 10;
+  const uint16_t current = analogRead(pin_current);
+
+  uint8_t val[6];
+  val[0] = temp_int & 0xff;
+  val[1] = (temp_int >> 8) & 0xff;
+  val[2] = hum_int & 0xff;
+  val[3] = (hum_int >> 8) & 0xff;
+  val[4] = current & 0xff;
+  val[5] = (current >> 8) & 0xff;
+
+  if (!hub_task.post(ds9990, writeDs9990, 1, val, sizeof(val)))
+  {
+#if DEBUG
+    Serial.println("hub mailbox full");
+#endif
+  }
+}
+
+// application on core 0, the only task that posts and fetches
+void appTask(void *parameter)
+{
+  (void)parameter;
+  float temperature = 0.0f;
+  float humidity = 0.0f;
+  uint32_t lastDhtReading = millis() - dht_interval_ms;
+
+  while (true)
+  {
+    OneWireMail mail;
+    while (hub_task.fetch(mail))
+    {
+      // the master wrote the brake byte, the mail carries byte 0 of the memory
+      if ((mail.activity.write_start == 0) && (mail.activity.write_end != mail.activity.write_start))
+      {
+        digitalWrite(pin_led, mail.data[0]);
+        digitalWrite(pin_brake, mail.data[0]);
+      }
+
+      // the master got the values, the next request gets fresh ones
+      if (mail.activity.read)
+        postValues(temperature, humidity);
+    }
+
+    // blocks for ~250 ms, the hub doesn't notice
+    if ((millis() - lastDhtReading) >= dht_interval_ms)
+    {
+      lastDhtReading = millis();
+      const float h = dht.readHumidity();
+      const float t = dht.readTemperature();
+      if (!isnan(h) && !isnan(t))
+      {
+        humidity = h;
+        temperature = t;
+        postValues(temperature, humidity);
+      }
+#if DEBUG
+      Serial.printf("T = %.1f / H = %.1f / transactions = %u / dropped = %u\n", temperature, humidity, hub_task.getProcessed(), hub_task.fetchDropped());
+#endif
+    }
+
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+  }
+}
+
+void setup()
+{
+#if DEBUG
+  Serial.begin(921600);
+  Serial.println("OneWire-Hub");
+#endif
+
+  pinMode(pin_led, OUTPUT);
+  pinMode(pin_brake, OUTPUT);
+
+  ds9990.setOverdrive(); // answers OVERDRIVE SKIP / MATCH ROM, needs OVERDRIVE_ENABLE (see platformio.ini)
+  hub.attach(ds9990);
+
+  uint8_t val[8];
+  memset(val, 0, sizeof(val));
+  ds9990.writeMemory(val, sizeof(val), 0); // the hub-task doesn't run yet
+
+  dht.begin();
+
+  hub_task.watch(ds9990, readDs9990, 0, 1); // brake byte
+  hub_task.start();
+  xTaskCreatePinnedToCore(appTask, "app", 4096, nullptr, 1, nullptr, app_core);
+}
+
+void loop()
+{
+  // loop() runs on the hub-core, everything happens in the two tasks
+  vTaskDelete(nullptr);
+}